@@ -18,14 +18,23 @@ namespace engine::audio {
             playImpl
     };
 
+    SourceTask MediaPlayer::streamTask = {
+            "MediaPlayer_StreamTask",
+            "MediaPlayer_StreamThread",
+            playStreamImpl,
+            [](){},
+            true
+    };
+
     SourceTask MediaPlayer::manageTask = {
             "MediaPlayer_ManageTask",
             "MediaPlayer_ManageThread",
             stopImpl
     };
 
-    unordered_map<u32, Source> MediaPlayer::sources;
+    std::unordered_map<u32, Source> MediaPlayer::sources;
     u32 MediaPlayer::playedSourceId = -1;
+    u32 MediaPlayer::streamedSourceId = -1;
 
     void MediaPlayer::load(
             const std::string& filepath,
@@ -47,6 +56,7 @@ namespace engine::audio {
         Source source;
         source.create(1);
         source.load(audioData);
+        io::AudioFile::releaseWav(audioData);
         source.setComponent(audioSourceComponent);
         source.setBuffer(0);
 
@@ -56,7 +66,7 @@ namespace engine::audio {
     }
 
     void MediaPlayer::play(const Source &source) {
-        playTask.isRunning = false;
+        playTask.stop();
         playTask.runnable = playImpl;
         playTask.run(source.get());
     }
@@ -122,7 +132,7 @@ namespace engine::audio {
     }
 
     void MediaPlayer::play() {
-        playTask.isRunning = false;
+        playTask.stop();
         playTask.runnable = playImpl;
         playTask.run(playedSourceId);
     }
@@ -142,9 +152,17 @@ namespace engine::audio {
     }
 
     void MediaPlayer::playStream(const Source &source) {
-        playTask.isRunning = false;
-        playTask.runnable = playStreamImpl;
-        playTask.run(source.get());
+        stopStream();
+        streamedSourceId = source.get();
+        streamTask.run(streamedSourceId);
+    }
+
+    void MediaPlayer::stopStream() {
+        // stream loop ends with its source, so next run() doesn't wait until previous track ends
+        if (streamTask.isRunning()) {
+            stopImpl(streamedSourceId);
+        }
+        streamTask.stop();
     }
 
     void MediaPlayer::playStreamImpl(const u32 &sourceId) {
@@ -155,8 +173,8 @@ namespace engine::audio {
     }
 
     void MediaPlayer::playStream() {
-        playTask.isRunning = false;
-        playTask.runnable = playStreamImpl;
-        playTask.run(playedSourceId);
+        stopStream();
+        streamedSourceId = playedSourceId;
+        streamTask.run(streamedSourceId);
     }
 }
\ No newline at end of file
@@ -19,6 +19,20 @@ namespace engine::audio {
     int Attenuation::EXPONENT_DISTANCE_CLAMPED = AL_EXPONENT_DISTANCE_CLAMPED;
     int Attenuation::DEFAULT = EXPONENT_DISTANCE_CLAMPED;
 
+    // streamed buffers are copied into OpenAL right away, so few pooled blocks serve all streams
+    static PoolAllocator& stream_buffer_pool() {
+        static auto* pool = new PoolAllocator(audio_stream_buffer_size, default_alignment, 2, heap_allocator(MemoryTag::AUDIO));
+        return *pool;
+    }
+
+    // custom cursors may have bigger buffers, than pool block
+    static Allocator& stream_buffer_allocator(size_t size) {
+        if (size <= audio_stream_buffer_size) {
+            return stream_buffer_pool();
+        }
+        return heap_allocator(MemoryTag::AUDIO);
+    }
+
     void AudioSourceComponent::serialize(YAML::Emitter &out) {
         out << YAML::BeginMap;
         out << YAML::Key << "AudioSourceComponent";
@@ -124,20 +138,22 @@ namespace engine::audio {
 
         io::AudioFile::open(filepath.c_str());
         format = io::AudioFile::readWavHeaders(filepath.c_str());
-        cursor = { static_cast<u8>(format.size / kb_512), kb_512 };
+        cursor = { static_cast<u8>(format.size / audio_stream_buffer_size), audio_stream_buffer_size };
 
         create(cursor.bufferCount - buffers.size());
 
+        Allocator& allocator = stream_buffer_allocator(cursor.bufferSize);
+        char* data = (char*) allocator.allocate(cursor.bufferSize);
         for (u32 i = 0 ; i < buffers.size() ; i++) {
-            char* data = io::AudioFile::streamWav((s64) (i * cursor.bufferSize), (s64) cursor.bufferSize);
+            io::AudioFile::streamWav(data, (s64) (i * cursor.bufferSize), (s64) cursor.bufferSize);
             AudioData subData {
                 {static_cast<s32>(cursor.bufferSize), format.frequency, format.channels },
                 data,
             };
 
             buffers[i].load(subData);
-            delete[] data;
         }
+        allocator.deallocate(data, cursor.bufferSize);
     }
 
     void Source::play() const {
@@ -184,13 +200,15 @@ namespace engine::audio {
                 cursorValue = bufferSize - dataSizeToCopy;
             }
 
-            char* data = io::AudioFile::streamWav((s64) (currentBufferIndex * bufferSize), (s64) bufferSize);
+            Allocator& allocator = stream_buffer_allocator(bufferSize);
+            char* data = (char*) allocator.allocate(bufferSize);
+            io::AudioFile::streamWav(data, (s64) (currentBufferIndex * bufferSize), (s64) bufferSize);
             AudioData audioSubData {
                 { bufferSize, format.frequency, format.channels },
                 data
             };
             Buffer::load(buffer, audioSubData);
-            delete[] data;
+            allocator.deallocate(data, bufferSize);
 
             alCall(alSourceQueueBuffers, id, 1, &buffer);
 
@@ -22,6 +22,7 @@ namespace engine::core {
         PROFILE_FUNCTION();
         ENGINE_INFO("onCreate()");
         jobSystem = createScope<JobSystem<>>();
+        createSimulationSystems();
         // setup window, input, graphics
         RenderScheduler->execute([this]() {
             if (!ProjectProps::createFromFile("properties.yaml", projectProps)) {
@@ -100,13 +101,19 @@ namespace engine::core {
         });
         ScriptSystem::onDestroy();
         waitAllJobs();
+        // memory, that subsystems still hold at exit
+        MemoryTracker::log();
     }
 
     void Application::update() {
+        if (projectProps.renderLatency > 0) {
+            updatePipelined();
+            return;
+        }
         PROFILE_FUNCTION();
         Timer timer("Application::update()", 30);
         // update simulation systems
-        ThreadPoolScheduler->execute([this]() {
+        JobHandle simulation = ThreadPoolScheduler->execute([this]() {
             onSimulationUpdate();
         });
         // update render systems
@@ -131,8 +138,59 @@ namespace engine::core {
             m_Window->onUpdate();
         });
         // sync simulation with delta time
+        // main thread helps simulation instead of draining the whole pool
+        RenderScheduler->wait();
+        ThreadPoolScheduler->waitFor(simulation);
+        applySnapshotRequest();
+        FrameArena::nextFrame();
+        dt = timer.stop();
+        PROFILE_ON_FRAME_UPDATED();
+    }
+
+    void Application::updatePipelined() {
+        PROFILE_FUNCTION();
+        Timer timer("Application::updatePipelined()", 30);
+        // simulate next frame and copy it into back buffer of render snapshot
+        JobHandle simulation = ThreadPoolScheduler->execute([this]() {
+            onSimulationUpdate();
+            if (activeScene) {
+                renderSnapshot.extract(*activeScene);
+            }
+        });
+        // meanwhile render previous frame from front buffer, it doesn't touch active scene
+        RenderScheduler->execute([this]() {
+            Scene& scene = *renderSnapshot.getFront();
+            if (!scene.isEmpty()) {
+                RenderSystem::onUpdate(scene);
+            }
+        });
+        // update monitor and inputs
+        if (enableMouseCursor) {
+            Input::updateMousePosition();
+        }
+        onEventUpdate();
+#ifndef VISUAL
+        RenderScheduler->execute([this]() {
+            m_Window->onUpdate();
+        });
+#endif
+        // sync point: next frame becomes visible to render
+        RenderScheduler->wait();
+        ThreadPoolScheduler->waitFor(simulation);
+        applySnapshotRequest();
+        renderSnapshot.swap();
+#ifdef VISUAL
+        // ImGui tools edit active scene, so they run only when simulation is stopped
+        RenderScheduler->execute([this]() {
+            Visual::begin();
+            Visual::onUpdate(dt);
+            onVisualDraw();
+            Visual::end();
+            m_Window->onUpdate();
+        });
         RenderScheduler->wait();
-        ThreadPoolScheduler->wait();
+#endif
+        FrameArena::nextFrame();
         dt = timer.stop();
         PROFILE_ON_FRAME_UPDATED();
     }
@@ -173,7 +231,7 @@ namespace engine::core {
         if (Visual::blocksKeyboard())
             return;
 #endif
-        EventRegistry::onKeyPressedMap[keyCode].function(keyCode);
+        EventRegistry::dispatch(EventRegistry::onKeyPressedMap, keyCode);
     }
 
     void Application::onKeyHold(event::KeyCode keyCode) {
@@ -222,7 +280,7 @@ namespace engine::core {
         if (Visual::blocksKeyboard())
             return;
 #endif
-        EventRegistry::onKeyReleasedMap[keyCode].function(keyCode);
+        EventRegistry::dispatch(EventRegistry::onKeyReleasedMap, keyCode);
         EventRegistry::onKeyHoldMap[keyCode] = false;
     }
 
@@ -233,7 +291,7 @@ namespace engine::core {
         if (Visual::blocksMouse())
             return;
 #endif
-        EventRegistry::onMousePressedMap[mouseCode].function(mouseCode);
+        EventRegistry::dispatch(EventRegistry::onMousePressedMap, mouseCode);
         EventRegistry::mouseHoldMap[mouseCode] = true;
     }
 
@@ -244,7 +302,7 @@ namespace engine::core {
         if (Visual::blocksMouse())
             return;
 #endif
-        EventRegistry::onMouseReleasedMap[mouseCode].function(mouseCode);
+        EventRegistry::dispatch(EventRegistry::onMouseReleasedMap, mouseCode);
         EventRegistry::mouseHoldMap[mouseCode] = false;
     }
 
@@ -291,6 +349,28 @@ namespace engine::core {
         RenderSystem::activeScene = activeScene;
         ScriptSystem::activeScene = activeScene;
         Physics::activeScene = activeScene;
+        TransformHierarchy::activeScene = activeScene;
+    }
+
+    void Application::requestSceneSnapshot() {
+        snapshotRequest = SnapshotRequest::TAKE;
+    }
+
+    void Application::requestSceneRestore() {
+        snapshotRequest = SnapshotRequest::RESTORE;
+    }
+
+    void Application::applySnapshotRequest() {
+        SnapshotRequest request = snapshotRequest.exchange(SnapshotRequest::NONE);
+        if (request == SnapshotRequest::NONE || !activeScene) {
+            return;
+        }
+        if (request == SnapshotRequest::TAKE && !editSnapshot) {
+            editSnapshot = activeScene->getRegistry().snapshot();
+        } else if (request == SnapshotRequest::RESTORE && editSnapshot) {
+            activeScene->getRegistry().restore(*editSnapshot);
+            editSnapshot.reset();
+        }
     }
 
     void Application::restart() {
@@ -366,12 +446,27 @@ namespace engine::core {
         RenderSystem::skyboxRenderer.init();
     }
 
-    void Application::onSimulationUpdate() {
-        if (activeScene && !activeScene->isEmpty()) {
+    void Application::createSimulationSystems() {
+        simulationSystems.clear();
+        // collision callbacks must record structural changes into command buffers
+        simulationSystems.addSystem("Physics", [this]() {
             Physics::onUpdate(dt);
+        }).write<Velocity, Transform3dComponent, CollisionTransform, SphereCollider, AABBCollider, PlaneCollider>();
+        // scripts and application may touch any component
+        simulationSystems.addSystem("Scripts", [this]() {
             ScriptSystem::onUpdate(dt);
+        }).makeExclusive();
+        simulationSystems.addSystem("Application", [this]() {
             onUpdate();
-
+        }).makeExclusive();
+        // sync point: apply structural changes recorded by systems
+        simulationSystems.addSystem("Commands", [this]() {
+            activeScene->getRegistry().flushCommands();
+        }).makeExclusive();
+        simulationSystems.addSystem("TransformHierarchy", []() {
+            TransformHierarchy::onUpdate();
+        }).write<Transform3dComponent, HierarchyComponent>();
+        simulationSystems.addSystem("Camera", [this]() {
             auto& camera = activeScene->getCamera();
             camera.onUpdate(dt);
 
@@ -389,6 +484,12 @@ namespace engine::core {
                 RUNTIME_INFO("mouseHold: button middle");
                 camera.applyMouseZoom();
             }
+        }).write<Camera3dComponent>();
+    }
+
+    void Application::onSimulationUpdate() {
+        if (activeScene && !activeScene->isEmpty()) {
+            simulationSystems.run(*ThreadPoolScheduler);
         } else {
             ENGINE_WARN("Active scene is empty!");
         }
@@ -580,9 +681,9 @@ namespace engine::core {
 
         vector<Batch3d> entities;
         for (int i = 0; i < model.meshes.size(); i++) {
-            auto modelMesh = model.meshes[i];
+            const auto& modelMesh = model.meshes[i];
             BaseMeshComponent<BatchVertex<Vertex3d>> meshComponent;
-            meshComponent.mesh = modelMesh.toMesh<BatchVertex<Vertex3d>>([](const io::ModelVertex& modelVertex) {
+            meshComponent.mesh = modelMesh.toMesh([](const io::ModelVertex& modelVertex) {
                 return BatchVertex<Vertex3d> {
                         modelVertex.position,
                         modelVertex.uv,
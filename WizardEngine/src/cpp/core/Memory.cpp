@@ -0,0 +1,329 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <core/Memory.h>
+#include <core/Assert.h>
+
+#include <atomic>
+#include <algorithm>
+
+namespace engine::core {
+
+    const char* memory_tag_name(MemoryTag tag) {
+        switch (tag) {
+            case MemoryTag::GENERAL: return "General";
+            case MemoryTag::ECS: return "ECS";
+            case MemoryTag::GRAPHICS: return "Graphics";
+            case MemoryTag::AUDIO: return "Audio";
+            case MemoryTag::NETWORK: return "Network";
+        }
+        return "Unknown";
+    }
+
+    // MemoryTracker
+
+    struct TagCounters {
+        std::atomic<size_t> allocated { 0 };
+        std::atomic<size_t> peak { 0 };
+        std::atomic<size_t> allocations { 0 };
+    };
+
+    static TagCounters tag_counters[memory_tag_count];
+
+    void MemoryTracker::onAllocate(MemoryTag tag, size_t size) {
+        TagCounters& counters = tag_counters[(u32) tag];
+        size_t allocated = counters.allocated.fetch_add(size, std::memory_order_relaxed) + size;
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = counters.peak.load(std::memory_order_relaxed);
+        while (allocated > peak && !counters.peak.compare_exchange_weak(peak, allocated, std::memory_order_relaxed));
+    }
+
+    void MemoryTracker::onDeallocate(MemoryTag tag, size_t size) {
+        TagCounters& counters = tag_counters[(u32) tag];
+        counters.allocated.fetch_sub(size, std::memory_order_relaxed);
+        counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MemoryStats MemoryTracker::getStats(MemoryTag tag) {
+        TagCounters& counters = tag_counters[(u32) tag];
+        MemoryStats stats;
+        stats.allocated = counters.allocated.load(std::memory_order_relaxed);
+        stats.peak = counters.peak.load(std::memory_order_relaxed);
+        stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void MemoryTracker::log() {
+        for (u32 i = 0 ; i < memory_tag_count ; i++) {
+            MemoryStats stats = getStats((MemoryTag) i);
+            ENGINE_INFO("Memory {0}: allocated {1} bytes in {2} allocations, peak {3} bytes",
+                        memory_tag_name((MemoryTag) i), stats.allocated, stats.allocations, stats.peak);
+        }
+    }
+
+    // AlignedAllocator
+
+    void* AlignedAllocator::allocate(size_t size, size_t alignment) {
+        void* memory = ::operator new(size, std::align_val_t(alignment));
+        MemoryTracker::onAllocate(m_Tag, size);
+        return memory;
+    }
+
+    void AlignedAllocator::deallocate(void* memory, size_t size, size_t alignment) {
+        if (memory == nullptr) return;
+        ::operator delete(memory, std::align_val_t(alignment));
+        MemoryTracker::onDeallocate(m_Tag, size);
+    }
+
+    Allocator& heap_allocator(MemoryTag tag) {
+        static AlignedAllocator* allocators[memory_tag_count] = {
+                new AlignedAllocator(MemoryTag::GENERAL),
+                new AlignedAllocator(MemoryTag::ECS),
+                new AlignedAllocator(MemoryTag::GRAPHICS),
+                new AlignedAllocator(MemoryTag::AUDIO),
+                new AlignedAllocator(MemoryTag::NETWORK)
+        };
+        return *allocators[(u32) tag];
+    }
+
+    // PoolAllocator
+
+    PoolAllocator::PoolAllocator(size_t blockSize, size_t blockAlignment, u32 blocksPerPage, Allocator& upstream)
+    : Allocator(upstream.getTag()), m_Upstream(upstream), m_BlocksPerPage(blocksPerPage) {
+        ENGINE_ASSERT(blocksPerPage > 0, "PoolAllocator() -> page must have at least one block!");
+        // free blocks store link to next one in their memory
+        m_BlockAlignment = std::max(blockAlignment, alignof(FreeBlock));
+        m_BlockSize = std::max(blockSize, sizeof(FreeBlock));
+        m_BlockSize = (m_BlockSize + m_BlockAlignment - 1) & ~(m_BlockAlignment - 1);
+    }
+
+    PoolAllocator::~PoolAllocator() {
+        ENGINE_ASSERT(m_UsedBlocks == 0, "~PoolAllocator() -> blocks are still in use!");
+        for (void* page : m_Pages) {
+            m_Upstream.deallocate(page, m_BlockSize * m_BlocksPerPage, m_BlockAlignment);
+        }
+    }
+
+    void* PoolAllocator::allocate([[maybe_unused]] size_t size, [[maybe_unused]] size_t alignment) {
+        ENGINE_ASSERT(size <= m_BlockSize && alignment <= m_BlockAlignment, "PoolAllocator::allocate() -> size or alignment is bigger than pool block!");
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_FreeBlocks == nullptr) {
+            u8* page = (u8*) m_Upstream.allocate(m_BlockSize * m_BlocksPerPage, m_BlockAlignment);
+            m_Pages.emplace_back(page);
+            // link blocks in address order, so new page is used from its start
+            for (u32 i = m_BlocksPerPage ; i > 0 ; i--) {
+                auto* block = (FreeBlock*) (page + (i - 1) * m_BlockSize);
+                block->next = m_FreeBlocks;
+                m_FreeBlocks = block;
+            }
+        }
+        FreeBlock* block = m_FreeBlocks;
+        m_FreeBlocks = block->next;
+        m_UsedBlocks++;
+        return block;
+    }
+
+    void PoolAllocator::deallocate(void* memory, size_t, size_t) {
+        if (memory == nullptr) return;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto* block = (FreeBlock*) memory;
+        block->next = m_FreeBlocks;
+        m_FreeBlocks = block;
+        m_UsedBlocks--;
+    }
+
+    size_t PoolAllocator::getUsedBlocks() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_UsedBlocks;
+    }
+
+    size_t PoolAllocator::getPageCount() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Pages.size();
+    }
+
+    // FreeListAllocator
+
+    // size of each block is multiple of it, so block ends are always aligned for FreeBlock
+    constexpr size_t free_list_granularity = alignof(std::max_align_t);
+
+    FreeListAllocator::FreeListAllocator(size_t regionSize, Allocator& upstream)
+    : Allocator(upstream.getTag()), m_Upstream(upstream), m_RegionSize(regionSize) {}
+
+    FreeListAllocator::~FreeListAllocator() {
+        ENGINE_ASSERT(m_Used == 0, "~FreeListAllocator() -> blocks are still in use!");
+        for (auto& region : m_Regions) {
+            m_Upstream.deallocate(region.first, region.second + free_list_granularity, free_list_granularity);
+        }
+    }
+
+    void* FreeListAllocator::allocate(size_t size, size_t alignment) {
+        ENGINE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "FreeListAllocator::allocate() -> alignment must be power of 2!");
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        size_t maxSize = sizeof(BlockHeader) + alignment + size + free_list_granularity;
+        for (;;) {
+            FreeBlock* previous = nullptr;
+            for (FreeBlock* block = m_FreeBlocks ; block != nullptr ; previous = block, block = block->next) {
+                uintptr_t start = (uintptr_t) block;
+                uintptr_t memory = (start + sizeof(BlockHeader) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+                size_t blockSize = memory + size - start;
+                blockSize = (blockSize + free_list_granularity - 1) & ~(free_list_granularity - 1);
+                if (blockSize > block->size) continue;
+
+                FreeBlock* next = block->next;
+                // rest of block stays free, if it's big enough for another allocation
+                if (block->size - blockSize >= sizeof(FreeBlock) + free_list_granularity) {
+                    auto* rest = (FreeBlock*) (start + blockSize);
+                    rest->size = block->size - blockSize;
+                    rest->next = next;
+                    next = rest;
+                } else {
+                    blockSize = block->size;
+                }
+                if (previous) {
+                    previous->next = next;
+                } else {
+                    m_FreeBlocks = next;
+                }
+
+                auto* header = (BlockHeader*) (memory - sizeof(BlockHeader));
+                header->offset = memory - start;
+                header->size = blockSize;
+                m_Used += blockSize;
+                return (void*) memory;
+            }
+            addRegion(std::max(m_RegionSize, maxSize));
+        }
+    }
+
+    void FreeListAllocator::deallocate(void* memory, size_t, size_t) {
+        if (memory == nullptr) return;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto* header = (BlockHeader*) ((u8*) memory - sizeof(BlockHeader));
+        auto* block = (FreeBlock*) ((u8*) memory - header->offset);
+        block->size = header->size;
+        m_Used -= block->size;
+
+        FreeBlock* previous = nullptr;
+        FreeBlock* next = m_FreeBlocks;
+        while (next != nullptr && next < block) {
+            previous = next;
+            next = next->next;
+        }
+        // regions have unused tail, so blocks of different regions are never adjacent
+        block->next = next;
+        if (next != nullptr && (u8*) block + block->size == (u8*) next) {
+            block->size += next->size;
+            block->next = next->next;
+        }
+        if (previous != nullptr) {
+            previous->next = block;
+            if ((u8*) previous + previous->size == (u8*) block) {
+                previous->size += block->size;
+                previous->next = block->next;
+            }
+        } else {
+            m_FreeBlocks = block;
+        }
+    }
+
+    size_t FreeListAllocator::getUsed() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Used;
+    }
+
+    size_t FreeListAllocator::getCapacity() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Capacity;
+    }
+
+    void FreeListAllocator::addRegion(size_t size) {
+        size = (size + free_list_granularity - 1) & ~(free_list_granularity - 1);
+        void* region = m_Upstream.allocate(size + free_list_granularity, free_list_granularity);
+        m_Regions.emplace_back(region, size);
+        m_Capacity += size;
+
+        auto* block = (FreeBlock*) region;
+        block->size = size;
+        FreeBlock* previous = nullptr;
+        FreeBlock* next = m_FreeBlocks;
+        while (next != nullptr && next < block) {
+            previous = next;
+            next = next->next;
+        }
+        block->next = next;
+        if (previous != nullptr) {
+            previous->next = block;
+        } else {
+            m_FreeBlocks = block;
+        }
+    }
+
+    // ArenaAllocator
+
+    ArenaAllocator::ArenaAllocator(size_t blockSize, Allocator& upstream)
+    : Allocator(upstream.getTag()), m_Upstream(upstream), m_BlockSize(blockSize) {}
+
+    ArenaAllocator::~ArenaAllocator() {
+        releaseBlocks();
+    }
+
+    void* ArenaAllocator::allocate(size_t size, size_t alignment) {
+        ENGINE_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "ArenaAllocator::allocate() -> alignment must be power of 2!");
+        for (;;) {
+            if (m_Block < m_Blocks.size()) {
+                Block& block = m_Blocks[m_Block];
+                uintptr_t address = (uintptr_t) (block.data + m_Offset);
+                size_t offset = ((address + alignment - 1) & ~(uintptr_t) (alignment - 1)) - (uintptr_t) block.data;
+                if (offset + size <= block.size) {
+                    m_Offset = offset + size;
+                    m_Used += size;
+                    m_Peak = std::max(m_Peak, m_Used);
+                    m_Last = block.data + offset;
+                    return m_Last;
+                }
+                // tail of block is wasted until reset
+                m_Block++;
+                m_Offset = 0;
+                continue;
+            }
+            // oversized allocations get dedicated block
+            addBlock(std::max(m_BlockSize, size + alignment));
+        }
+    }
+
+    void ArenaAllocator::deallocate(void* memory, size_t size, size_t) {
+        if (memory == nullptr || memory != m_Last) return;
+        m_Offset = (u8*) memory - m_Blocks[m_Block].data;
+        m_Used -= size;
+        m_Last = nullptr;
+    }
+
+    void ArenaAllocator::reset() {
+        // blocks are merged into one, that fits all allocations since previous reset
+        if (m_Blocks.size() > 1) {
+            size_t capacity = m_Capacity;
+            releaseBlocks();
+            addBlock(capacity);
+        }
+        m_Block = 0;
+        m_Offset = 0;
+        m_Used = 0;
+        m_Last = nullptr;
+    }
+
+    void ArenaAllocator::addBlock(size_t size) {
+        m_Blocks.push_back({ (u8*) m_Upstream.allocate(size), size });
+        m_Capacity += size;
+    }
+
+    void ArenaAllocator::releaseBlocks() {
+        for (Block& block : m_Blocks) {
+            m_Upstream.deallocate(block.data, block.size);
+        }
+        m_Blocks.clear();
+        m_Capacity = 0;
+    }
+
+}
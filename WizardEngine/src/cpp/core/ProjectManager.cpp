@@ -10,6 +10,7 @@
 
 #include <fstream>
 #include <regex>
+#include <algorithm>
 
 namespace engine::core {
 
@@ -20,6 +21,7 @@ namespace engine::core {
         yaml::serialize(out, "title", title);
         yaml::serialize(out, "icon", icon);
         yaml::serialize(out, "launcher", launcher);
+        yaml::serialize(out, "renderLatency", renderLatency);
 
         out << YAML::BeginMap;
         out << YAML::Key << "window";
@@ -41,6 +43,11 @@ namespace engine::core {
             yaml::deserialize(root, "title", title);
             yaml::deserialize(root, "icon", icon);
             yaml::deserialize(root, "launcher", launcher);
+            yaml::deserialize(root, "renderLatency", renderLatency);
+            if (renderLatency < 0 || renderLatency > 1) {
+                ENGINE_WARN("ProjectProps: renderLatency {0} is not supported, only 0 or 1 frames", renderLatency);
+                renderLatency = std::clamp(renderLatency, 0, 1);
+            }
 
             auto window = root["window"];
             if (window) {
@@ -0,0 +1,37 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <core/frame_allocator.h>
+
+namespace engine::core {
+
+    static std::atomic<u64> frame_counter = 0;
+
+    FrameArena& FrameArena::get() {
+        static thread_local FrameArena arena;
+        return arena;
+    }
+
+    void FrameArena::nextFrame() {
+        frame_counter.fetch_add(1, std::memory_order_release);
+    }
+
+    u64 FrameArena::getFrame() {
+        return frame_counter.load(std::memory_order_acquire);
+    }
+
+    void* FrameArena::allocate(size_t size, size_t alignment) {
+        u64 frame = getFrame();
+        if (m_Frame != frame) {
+            m_Arena.reset();
+            m_Frame = frame;
+        }
+        return m_Arena.allocate(size, alignment);
+    }
+
+    void FrameArena::deallocate(void* memory, size_t size) {
+        m_Arena.deallocate(memory, size);
+    }
+
+}
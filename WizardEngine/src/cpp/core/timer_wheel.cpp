@@ -0,0 +1,153 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <core/timer_wheel.h>
+#include <core/Assert.h>
+
+namespace engine::core {
+
+    // furthest expiry, that fits into wheel, further timers wait on last level and cascade again
+    constexpr u64 timer_wheel_range = 1ull << (timer_wheel_levels * timer_wheel_slot_bits);
+    constexpr u64 timer_wheel_mask = timer_wheel_slots - 1;
+
+    TimerWheel::TimerWheel() {
+        std::fill(m_Slots, m_Slots + timer_wheel_levels * timer_wheel_slots, invalid_timer_index);
+    }
+
+    TimerHandle TimerWheel::insert(u64 delay, u64 period, const TimerFunction& function) {
+        ENGINE_ASSERT(function, "TimerWheel::insert() -> function is null!");
+        u32 index;
+        if (m_FreeTimer != invalid_timer_index) {
+            index = m_FreeTimer;
+            m_FreeTimer = m_Timers[index].next;
+        } else {
+            index = (u32) m_Timers.size();
+            m_Timers.emplace_back();
+        }
+
+        Timer& timer = m_Timers[index];
+        // timer never fires in current tick, as it may be already processed
+        timer.expiry = m_Tick + std::max<u64>(delay, 1);
+        timer.period = period;
+        timer.function = function;
+        link(index);
+        m_Size++;
+        return { index, timer.generation };
+    }
+
+    bool TimerWheel::cancel(const TimerHandle& handle) {
+        if (handle.index >= m_Timers.size()) return false;
+        Timer& timer = m_Timers[handle.index];
+        if (timer.generation != handle.generation || timer.slot == invalid_timer_index) return false;
+
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    void TimerWheel::advance(u64 tick, vector<TimerFunction>& expired) {
+        if (m_Size == 0) {
+            m_Tick = std::max(m_Tick, tick);
+            return;
+        }
+
+        while (m_Tick < tick) {
+            m_Tick++;
+            // when level wraps, next slot of upper level is spread over it
+            for (u32 level = 1 ; level < timer_wheel_levels ; level++) {
+                if (((m_Tick >> ((level - 1) * timer_wheel_slot_bits)) & timer_wheel_mask) != 0) break;
+                cascade(level);
+            }
+
+            u32& slot = m_Slots[m_Tick & timer_wheel_mask];
+            u32 index = slot;
+            slot = invalid_timer_index;
+            while (index != invalid_timer_index) {
+                Timer& timer = m_Timers[index];
+                u32 next = timer.next;
+                timer.slot = invalid_timer_index;
+                expired.emplace_back(timer.function);
+                if (timer.period > 0) {
+                    timer.expiry += timer.period;
+                    // periods, that were missed while wheel was behind, are skipped instead of fired in a burst
+                    if (timer.expiry <= tick) {
+                        timer.expiry += ((tick - timer.expiry) / timer.period + 1) * timer.period;
+                    }
+                    link(index);
+                } else {
+                    release(index);
+                }
+                index = next;
+            }
+        }
+    }
+
+    u64 TimerWheel::ticksToNextEvent() const {
+        for (u64 ticks = 1 ; ticks < timer_wheel_slots ; ticks++) {
+            u64 tick = m_Tick + ticks;
+            if ((tick & timer_wheel_mask) == 0 || m_Slots[tick & timer_wheel_mask] != invalid_timer_index) {
+                return ticks;
+            }
+        }
+        return timer_wheel_slots;
+    }
+
+    void TimerWheel::link(u32 index) {
+        Timer& timer = m_Timers[index];
+        // late timers fire in current tick, it's processed right after cascade
+        u64 expiry = std::max(timer.expiry, m_Tick);
+        u64 delta = std::min(expiry - m_Tick, timer_wheel_range - 1);
+        expiry = m_Tick + delta;
+
+        u32 level = 0;
+        while (level + 1 < timer_wheel_levels && delta >= (1ull << ((level + 1) * timer_wheel_slot_bits))) {
+            level++;
+        }
+        u32 slot = level * timer_wheel_slots + (u32) ((expiry >> (level * timer_wheel_slot_bits)) & timer_wheel_mask);
+
+        timer.slot = slot;
+        timer.prev = invalid_timer_index;
+        timer.next = m_Slots[slot];
+        if (timer.next != invalid_timer_index) {
+            m_Timers[timer.next].prev = index;
+        }
+        m_Slots[slot] = index;
+    }
+
+    void TimerWheel::unlink(u32 index) {
+        Timer& timer = m_Timers[index];
+        if (timer.prev != invalid_timer_index) {
+            m_Timers[timer.prev].next = timer.next;
+        } else {
+            m_Slots[timer.slot] = timer.next;
+        }
+        if (timer.next != invalid_timer_index) {
+            m_Timers[timer.next].prev = timer.prev;
+        }
+        timer.slot = invalid_timer_index;
+    }
+
+    void TimerWheel::release(u32 index) {
+        Timer& timer = m_Timers[index];
+        timer.function = nullptr;
+        timer.generation++;
+        timer.slot = invalid_timer_index;
+        timer.prev = invalid_timer_index;
+        timer.next = m_FreeTimer;
+        m_FreeTimer = index;
+        m_Size--;
+    }
+
+    void TimerWheel::cascade(u32 level) {
+        u32& slot = m_Slots[level * timer_wheel_slots + ((m_Tick >> (level * timer_wheel_slot_bits)) & timer_wheel_mask)];
+        u32 index = slot;
+        slot = invalid_timer_index;
+        while (index != invalid_timer_index) {
+            u32 next = m_Timers[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+}
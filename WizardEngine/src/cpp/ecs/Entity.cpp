@@ -10,6 +10,24 @@ namespace engine::ecs {
         container->getRegistry().deleteEntity(id);
     }
 
+    EntityContainer::EntityContainer() {
+        // keep uuid index up to date with every add, replace and remove of UUIDComponent
+        registry.onAdded<UUIDComponent>([this](UUIDComponent* component) {
+            uuidIndex[component->uuid] = component->entityId;
+        });
+        registry.onRemoved<UUIDComponent>([this](UUIDComponent* component) {
+            auto it = uuidIndex.find(component->uuid);
+            if (it != uuidIndex.end() && it->second == component->entityId) {
+                uuidIndex.erase(it);
+            }
+        });
+    }
+
+    entity_id EntityContainer::findEntityId(int uuid) const {
+        auto it = uuidIndex.find(uuid);
+        return it != uuidIndex.end() ? it->second : invalid_entity_id;
+    }
+
     bool EntityContainer::isEmpty() {
         return registry.empty_entity();
     }
@@ -11,33 +11,19 @@ namespace engine::ecs {
     }
 
     Entity Scene::findEntity(const uuid &uuid) {
-        UUIDComponent uuidComponent(uuid);
-        entity_id entityId = registry.findEntity<UUIDComponent>([&uuidComponent](UUIDComponent* found) {
-            return *found == uuidComponent;
-        });
-        return { this, entityId };
+        return { this, findEntityId(uuid) };
     }
 
     Entity Scene::findEntity(const UUIDComponent& uuid) {
-        entity_id entityId = registry.findEntity<UUIDComponent>([&uuid](UUIDComponent* found) {
-            return *found == uuid;
-        });
-        return { this, entityId };
+        return { this, findEntityId(uuid.uuid) };
     }
 
     Entity Scene::findEntity(int uuid) {
-        UUIDComponent uuidComponent((engine::uuid(uuid)));
-        entity_id entityId = registry.findEntity<UUIDComponent>([&uuidComponent](UUIDComponent* found) {
-            return *found == uuidComponent;
-        });
-        return { this, entityId };
+        return { this, findEntityId(uuid) };
     }
 
     void Scene::findEntity(int uuid, Entity& entity) {
-        UUIDComponent uuidComponent((engine::uuid(uuid)));
-        entity_id entityId = registry.findEntity<UUIDComponent>([&uuidComponent](UUIDComponent* found) {
-            return *found == uuidComponent;
-        });
+        entity_id entityId = findEntityId(uuid);
         if (entityId != invalid_entity_id) {
             entity.setId(entityId);
         }
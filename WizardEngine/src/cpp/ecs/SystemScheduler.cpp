@@ -0,0 +1,59 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <ecs/SystemScheduler.h>
+
+namespace engine::ecs {
+
+    static bool intersects(const archetype_signature& components, const archetype_signature& otherComponents) {
+        for (component_id componentId : components) {
+            if (std::find(otherComponents.begin(), otherComponents.end(), componentId) != otherComponents.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool SystemAccess::conflicts(const SystemAccess& other) const {
+        return exclusive || other.exclusive
+        || intersects(writes, other.writes)
+        || intersects(writes, other.reads)
+        || intersects(reads, other.writes);
+    }
+
+    SystemAccess& SystemScheduler::addSystem(const std::string& name, const std::function<void()>& update) {
+        systems.push_back({ name, update, {} });
+        return systems.back().access;
+    }
+
+    void SystemScheduler::clear() {
+        systems.clear();
+        dependents.clear();
+        dependencies.clear();
+        pending.reset();
+    }
+
+    bool SystemScheduler::prepare() {
+        u32 size = (u32) systems.size();
+        if (size == 0) return false;
+
+        // conflicting systems are linked in the order they were added
+        dependents.assign(size, {});
+        dependencies.assign(size, 0);
+        for (u32 i = 0 ; i < size ; i++) {
+            for (u32 j = i + 1 ; j < size ; j++) {
+                if (systems[i].access.conflicts(systems[j].access)) {
+                    dependents[i].emplace_back(j);
+                    dependencies[j]++;
+                }
+            }
+        }
+
+        pending.reset(new std::atomic<u32>[size]);
+        for (u32 i = 0 ; i < size ; i++) {
+            pending[i].store(dependencies[i], std::memory_order_relaxed);
+        }
+        return true;
+    }
+}
@@ -4,29 +4,339 @@
 
 #include <ecs/ecs.h>
 
+#include <algorithm>
+#include <cstddef>
+
 namespace engine::ecs {
 
     vector<ComponentType>* BaseComponent::componentTypes;
+    unordered_map<u64, component_id>* BaseComponent::componentIds;
 
     u32 BaseComponent::registerComponentType(
             ComponentCreateFunction createFunction,
             ComponentDestroyFunction destroyFunction,
+            ComponentRelocateFunction relocateFunction,
             component_size size,
+            u64 typeHash,
             const char* typeName
     ) {
+        // types are registered during static initialization, so storage is created on first use
         if (componentTypes == nullptr) {
             componentTypes = new vector<ComponentType>();
+            componentIds = new unordered_map<u64, component_id>();
+        }
+
+        auto it = componentIds->find(typeHash);
+        if (it != componentIds->end()) {
+            return it->second;
         }
 
         u32 id = componentTypes->size();
+        componentTypes->emplace_back(createFunction, destroyFunction, relocateFunction, size, typeHash, typeName);
+        componentIds->emplace(typeHash, id);
+        return id;
+    }
+
+    static component_size alignColumn(component_size offset) {
+        return (offset + archetype_column_alignment - 1) & ~(archetype_column_alignment - 1);
+    }
 
-        for (u32 i = 0 ; i < componentTypes->size(); i++) {
-            auto componentType = componentTypes->at(i);
-            if (strcmp(componentType.name, typeName) == 0) return i;
+    Archetype::Archetype(const archetype_signature& signature) : signature(signature) {
+        component_size rowSize = sizeof(entity_id);
+        for (component_id componentId : signature) {
+            component_size size = BaseComponent::getSize(componentId);
+            sizes.emplace_back(size);
+            relocateFunctions.emplace_back(BaseComponent::getRelocateFunction(componentId));
+            rowSize += size + 2 * sizeof(component_version);
+        }
+        offsets.resize(signature.size());
+        versionOffsets.resize(signature.size());
+        if (!signature.empty()) {
+            columns.resize(signature.back() + 1, -1);
+            for (u32 i = 0 ; i < signature.size() ; i++) {
+                columns[signature[i]] = (s32) i;
+            }
         }
 
-        componentTypes->emplace_back(createFunction, destroyFunction, size, typeName);
-        return id;
+        // find how many rows fit into single chunk, taking columns alignment into account
+        chunkCapacity = std::max<u32>(1, archetype_chunk_size / rowSize);
+        while (true) {
+            component_size offset = chunkCapacity * sizeof(entity_id);
+            for (u32 i = 0 ; i < sizes.size() ; i++) {
+                offset = alignColumn(offset);
+                offsets[i] = offset;
+                offset += chunkCapacity * sizes[i];
+            }
+            for (u32 i = 0 ; i < sizes.size() ; i++) {
+                offset = alignColumn(offset);
+                versionOffsets[i] = offset;
+                offset += chunkCapacity * 2 * sizeof(component_version);
+            }
+            chunkSize = offset;
+            if (chunkSize <= archetype_chunk_size || chunkCapacity == 1) break;
+            chunkCapacity--;
+        }
+    }
+
+    Archetype::~Archetype() {
+        clear();
+    }
+
+    void Archetype::allocate(entity_id entityId, u32& chunk, u32& row) {
+        if (chunks.empty() || chunks.back().size == chunkCapacity) {
+            ArchetypeChunk newChunk;
+            if (freeChunks.empty()) {
+                newChunk.data = allocateChunk();
+            } else {
+                newChunk.data = freeChunks.back();
+                freeChunks.pop_back();
+            }
+            chunks.emplace_back(newChunk);
+        }
+
+        chunk = chunks.size() - 1;
+        ArchetypeChunk& lastChunk = chunks[chunk];
+        row = lastChunk.size++;
+        getEntities(lastChunk)[row] = entityId;
+        entityCount++;
+    }
+
+    void Archetype::reserve(u32 count) {
+        u32 freeRows = chunks.empty() ? 0 : chunkCapacity - chunks.back().size;
+        if (count <= freeRows) return;
+
+        u32 newChunks = (count - freeRows + chunkCapacity - 1) / chunkCapacity;
+        chunks.reserve(chunks.size() + newChunks);
+        while (freeChunks.size() < newChunks) {
+            freeChunks.emplace_back(allocateChunk());
+        }
+    }
+
+    entity_id Archetype::deallocate(u32 chunk, u32 row) {
+        u32 lastChunkIndex = chunks.size() - 1;
+        ArchetypeChunk& lastChunk = chunks[lastChunkIndex];
+        u32 lastRow = lastChunk.size - 1;
+        entity_id movedEntityId = invalid_entity_id;
+
+        if (chunk != lastChunkIndex || row != lastRow) {
+            ArchetypeChunk& destChunk = chunks[chunk];
+            movedEntityId = getEntities(lastChunk)[lastRow];
+            getEntities(destChunk)[row] = movedEntityId;
+            for (u32 i = 0 ; i < sizes.size() ; i++) {
+                relocate(i, getComponentData(chunk, row, i), getComponentData(lastChunkIndex, lastRow, i));
+                getChangedVersions(destChunk, i)[row] = getChangedVersions(lastChunk, i)[lastRow];
+                getAddedVersions(destChunk, i)[row] = getAddedVersions(lastChunk, i)[lastRow];
+            }
+        }
+
+        lastChunk.size--;
+        entityCount--;
+        if (lastChunk.size == 0) {
+            // keep single chunk memory for entities that will come next
+            if (freeChunks.empty()) {
+                freeChunks.emplace_back(lastChunk.data);
+            } else {
+                releaseChunk(lastChunk.data);
+            }
+            chunks.pop_back();
+        }
+
+        return movedEntityId;
+    }
+
+    PoolAllocator& archetype_chunk_pool() {
+        // never destroyed, so static registries can release their chunks at exit
+        static auto* pool = new PoolAllocator(archetype_chunk_size, archetype_column_alignment,
+                                              archetype_chunks_per_page, heap_allocator(MemoryTag::ECS));
+        return *pool;
+    }
+
+    u8* Archetype::allocateChunk() {
+        if (chunkSize <= archetype_chunk_size) {
+            return (u8*) archetype_chunk_pool().allocate(chunkSize, archetype_column_alignment);
+        }
+        return (u8*) heap_allocator(MemoryTag::ECS).allocate(chunkSize, archetype_column_alignment);
+    }
+
+    void Archetype::releaseChunk(u8* data) {
+        if (chunkSize <= archetype_chunk_size) {
+            archetype_chunk_pool().deallocate(data, chunkSize, archetype_column_alignment);
+        } else {
+            heap_allocator(MemoryTag::ECS).deallocate(data, chunkSize, archetype_column_alignment);
+        }
+    }
+
+    void Archetype::destroyComponents(u32 chunk, u32 row) {
+        for (u32 i = 0 ; i < signature.size() ; i++) {
+            auto destroyFunction = BaseComponent::getDestroyFunction(signature[i]);
+            destroyFunction((BaseComponent*) getComponentData(chunk, row, i));
+        }
+    }
+
+    void Archetype::clear() {
+        for (u32 c = 0 ; c < chunks.size() ; c++) {
+            for (u32 r = 0 ; r < chunks[c].size ; r++) {
+                destroyComponents(c, r);
+            }
+            releaseChunk(chunks[c].data);
+        }
+        chunks.clear();
+        for (u8* data : freeChunks) {
+            releaseChunk(data);
+        }
+        freeChunks.clear();
+        entityCount = 0;
+    }
+
+    void Archetype::permute(const vector<u32>& order) {
+        ENGINE_ASSERT(order.size() == entityCount, "Archetype::permute() failed -> order size must be equal to entity count!");
+
+        // single row is kept aside, while rows of its cycle are shifted into their places
+        vector<component_size> bufferOffsets(signature.size());
+        component_size bufferSize = 0;
+        for (u32 i = 0 ; i < signature.size() ; i++) {
+            bufferOffsets[i] = bufferSize;
+            bufferSize = alignColumn(bufferSize + sizes[i]);
+        }
+        std::unique_ptr<u8[]> buffer(new u8[std::max<component_size>(bufferSize, 1)]);
+        vector<component_version> bufferVersions(2 * signature.size());
+        entity_id bufferEntityId = invalid_entity_id;
+
+        auto moveRow = [this](u32 dst, u32 src) {
+            ArchetypeChunk& dstChunk = chunks[dst / chunkCapacity];
+            ArchetypeChunk& srcChunk = chunks[src / chunkCapacity];
+            u32 dstRow = dst % chunkCapacity;
+            u32 srcRow = src % chunkCapacity;
+            getEntities(dstChunk)[dstRow] = getEntities(srcChunk)[srcRow];
+            for (u32 i = 0 ; i < signature.size() ; i++) {
+                relocate(i, getColumnData(dstChunk, i) + dstRow * sizes[i], getColumnData(srcChunk, i) + srcRow * sizes[i]);
+                getChangedVersions(dstChunk, i)[dstRow] = getChangedVersions(srcChunk, i)[srcRow];
+                getAddedVersions(dstChunk, i)[dstRow] = getAddedVersions(srcChunk, i)[srcRow];
+            }
+        };
+
+        vector<bool> placed(entityCount, false);
+        for (u32 start = 0 ; start < entityCount ; start++) {
+            if (placed[start] || order[start] == start) continue;
+
+            // take first row of cycle into buffer
+            ArchetypeChunk& startChunk = chunks[start / chunkCapacity];
+            u32 startRow = start % chunkCapacity;
+            bufferEntityId = getEntities(startChunk)[startRow];
+            for (u32 i = 0 ; i < signature.size() ; i++) {
+                relocate(i, buffer.get() + bufferOffsets[i], getColumnData(startChunk, i) + startRow * sizes[i]);
+                bufferVersions[2 * i] = getChangedVersions(startChunk, i)[startRow];
+                bufferVersions[2 * i + 1] = getAddedVersions(startChunk, i)[startRow];
+            }
+
+            u32 row = start;
+            while (order[row] != start) {
+                moveRow(row, order[row]);
+                placed[row] = true;
+                row = order[row];
+            }
+
+            // put buffered row into last place of cycle
+            ArchetypeChunk& lastChunk = chunks[row / chunkCapacity];
+            u32 lastRow = row % chunkCapacity;
+            getEntities(lastChunk)[lastRow] = bufferEntityId;
+            for (u32 i = 0 ; i < signature.size() ; i++) {
+                relocate(i, getColumnData(lastChunk, i) + lastRow * sizes[i], buffer.get() + bufferOffsets[i]);
+                getChangedVersions(lastChunk, i)[lastRow] = bufferVersions[2 * i];
+                getAddedVersions(lastChunk, i)[lastRow] = bufferVersions[2 * i + 1];
+            }
+            placed[row] = true;
+        }
+    }
+
+    void Archetype::copy(Archetype& target, component_version version) {
+        ENGINE_ASSERT(target.signature == signature && target.entityCount == 0, "Archetype::copy() failed -> target must be empty archetype of the same signature!");
+        target.reserve(entityCount);
+        for (const ArchetypeChunk& chunk : chunks) {
+            ArchetypeChunk newChunk;
+            newChunk.data = target.freeChunks.back();
+            newChunk.size = chunk.size;
+            target.freeChunks.pop_back();
+
+            entity_id* entityIds = getEntities(chunk);
+            memcpy(newChunk.data, entityIds, chunk.size * sizeof(entity_id));
+            for (u32 i = 0 ; i < signature.size() ; i++) {
+                u8* src = getColumnData(chunk, i);
+                u8* dst = target.getColumnData(newChunk, i);
+                if (relocateFunctions[i]) {
+                    auto createFunction = BaseComponent::getCreateFunction(signature[i]);
+                    for (u32 row = 0 ; row < chunk.size ; row++) {
+                        createFunction(dst + row * sizes[i], entityIds[row], (BaseComponent*) (src + row * sizes[i]));
+                    }
+                } else {
+                    memcpy(dst, src, chunk.size * sizes[i]);
+                }
+                std::fill_n(target.getChangedVersions(newChunk, i), chunk.size, version);
+                std::fill_n(target.getAddedVersions(newChunk, i), chunk.size, version);
+            }
+            target.chunks.emplace_back(newChunk);
+        }
+        target.entityCount = entityCount;
+    }
+
+    void Archetype::copyRows(Archetype& target, component_version version) {
+        vector<u32> sourceColumns;
+        sourceColumns.reserve(target.signature.size());
+        for (component_id componentId : target.signature) {
+            ENGINE_ASSERT(contains(componentId), "Archetype::copyRows() failed -> target must not have components, which source doesn't have!");
+            sourceColumns.emplace_back(columns[componentId]);
+        }
+
+        target.reserve(entityCount);
+        for (const ArchetypeChunk& chunk : chunks) {
+            entity_id* entityIds = getEntities(chunk);
+            for (u32 row = 0 ; row < chunk.size ; row++) {
+                u32 targetChunk, targetRow;
+                target.allocate(entityIds[row], targetChunk, targetRow);
+                const ArchetypeChunk& newChunk = target.chunks[targetChunk];
+                for (u32 i = 0 ; i < target.signature.size() ; i++) {
+                    u32 column = sourceColumns[i];
+                    u8* src = getColumnData(chunk, column) + row * sizes[column];
+                    u8* dst = target.getColumnData(newChunk, i) + targetRow * target.sizes[i];
+                    if (relocateFunctions[column]) {
+                        BaseComponent::getCreateFunction(signature[column])(dst, entityIds[row], (BaseComponent*) src);
+                    } else {
+                        memcpy(dst, src, sizes[column]);
+                    }
+                    target.getChangedVersions(newChunk, i)[targetRow] = version;
+                    target.getAddedVersions(newChunk, i)[targetRow] = version;
+                }
+            }
+        }
+    }
+
+    size_t Query::getEntityCount() const {
+        size_t count = 0;
+        for (Archetype* archetype : archetypes) {
+            count += archetype->getEntityCount();
+        }
+        return count;
+    }
+
+    void Query::match(Archetype* archetype) {
+        for (component_id componentId : components) {
+            if (!archetype->contains(componentId)) return;
+        }
+
+        archetypes.emplace_back(archetype);
+        for (component_id componentId : components) {
+            columns.emplace_back(archetype->getColumn(componentId));
+        }
+    }
+
+    void Query::clear() {
+        archetypes.clear();
+        columns.clear();
+    }
+
+    u32 Query::nextId() {
+        static std::atomic<u32> queriesCounter { 0 };
+        return queriesCounter++;
     }
 
     Registry::~Registry() {
@@ -34,77 +344,581 @@ namespace engine::ecs {
     }
 
     entity_id Registry::createEntity() {
-        // allocate entity
-        auto* newEntity = new entity();
-        // add entity
-        newEntity->first = entities.size();
-        entities.emplace_back(newEntity);
-        return newEntity;
+        // every entity starts its life in archetype without components
+        return createEntity(getArchetype({}));
+    }
+
+    entity_id Registry::createEntity(Archetype* archetype) {
+        // reuse deleted record or grow entity table
+        u32 index;
+        if (freeEntity != invalid_entity_index) {
+            index = freeEntity;
+            freeEntity = entities[index].nextFree;
+            entities[index].nextFree = invalid_entity_index;
+        } else {
+            index = entities.size();
+            entities.emplace_back();
+        }
+        aliveCount++;
+        entity_id newEntityId = make_entity_id(index, entities[index].generation);
+        u32 chunk, row;
+        archetype->allocate(newEntityId, chunk, row);
+        entities[index].archetype = archetype;
+        entities[index].chunk = chunk;
+        entities[index].row = row;
+        return newEntityId;
+    }
+
+    bool Registry::isAlive(entity_id entityId) const {
+        u32 index = entity_index(entityId);
+        return index < entities.size()
+        && entities[index].archetype != nullptr
+        && entities[index].generation == entity_generation(entityId);
+    }
+
+    static inline void releaseRecord(entity& record) {
+        record.archetype = nullptr;
+        // generation 0 is reserved for invalid_entity_id
+        if (++record.generation == 0) {
+            record.generation = 1;
+        }
     }
 
     void Registry::deleteEntity(entity_id& entityId) {
         ENGINE_ASSERT(entityId != invalid_entity_id, "deleteEntity() failed -> invalid entity id!");
-        // remove component ids and indexes
-        auto& entityData = toEntityData(entityId);
-        for (const auto& componentIdAndIndex : entityData) {
-            removeComponentInternal(componentIdAndIndex.first, componentIdAndIndex.second);
-        }
-        // delete actual entity by index and replace it with last one
-        u32 destIndex = toEntityIndex(entityId);
-        u32 srcIndex = entities.size() - 1;
-        delete entities[destIndex];
-        entities[destIndex] = entities[srcIndex];
-        entities[destIndex]->first = destIndex;
-        entities.pop_back();
+        // destroy components and release archetype row
+        entity* record = toEntity(entityId);
+        Archetype* archetype = record->archetype;
+        for (u32 i = 0 ; i < archetype->signature.size() ; i++) {
+            logRemoved(archetype->signature[i], entityId);
+            notifyRemoved(archetype->signature[i], (BaseComponent*) archetype->getComponentData(record->chunk, record->row, i));
+        }
+        archetype->destroyComponents(record->chunk, record->row);
+        entity_id movedEntityId = archetype->deallocate(record->chunk, record->row);
+        if (movedEntityId != invalid_entity_id) {
+            toEntity(movedEntityId)->chunk = record->chunk;
+            toEntity(movedEntityId)->row = record->row;
+        }
+        // invalidate all handles of this record and put it into free list
+        releaseRecord(*record);
+        record->nextFree = freeEntity;
+        freeEntity = entity_index(entityId);
+        aliveCount--;
         entityId = invalid_entity_id;
     }
 
-    // todo crash when trying to remove existing component
-    void Registry::removeComponentInternal(component_id componentId, u32 componentIndex) {
-        auto destroyFunction = BaseComponent::getDestroyFunction(componentId);
-        component_data data = components[componentId];
-        component_size typeSize = BaseComponent::getSize(componentId);
-        u32 srcIndex = data.size() - typeSize;
+    void* Registry::addComponentData(entity_id entityId, component_id componentId) {
+        entity* record = toEntity(entityId);
+        s32 column = record->archetype->getColumn(componentId);
+        if (column >= 0) {
+            // entity already has this component, so we just replace it
+            void* data = record->archetype->getComponentData(record->chunk, record->row, column);
+            notifyRemoved(componentId, (BaseComponent*) data);
+            BaseComponent::getDestroyFunction(componentId)((BaseComponent*) data);
+            stampChanged(record, column);
+            return data;
+        }
+
+        Archetype* archetype = getAddArchetype(record->archetype, componentId);
+        moveEntity(entityId, archetype);
+        column = archetype->getColumn(componentId);
+        stampAdded(record, column);
+        return archetype->getComponentData(record->chunk, record->row, column);
+    }
+
+    bool Registry::removeComponent(entity_id entityId, component_id componentId) {
+        entity* record = toEntity(entityId);
+        if (!record->archetype->contains(componentId)) {
+            return false;
+        }
+
+        moveEntity(entityId, getRemoveArchetype(record->archetype, componentId));
+        return true;
+    }
+
+    void Registry::logRemoved(component_id componentId, entity_id entityId) {
+        if (componentId < removedComponents.size() && removedComponents[componentId].tracked) {
+            removedComponents[componentId].entities.emplace_back(entityId, version);
+        }
+    }
+
+    ComponentHooks& Registry::getHooks(component_id componentId) {
+        if (componentId >= hooks.size()) {
+            hooks.resize(componentId + 1);
+        }
+        return hooks[componentId];
+    }
+
+    Archetype* Registry::getArchetype(const archetype_signature& signature) {
+        auto it = archetypes.find(signature);
+        if (it != archetypes.end()) {
+            return it->second.get();
+        }
+
+        auto* archetype = new Archetype(signature);
+        archetypes[signature] = Scope<Archetype>(archetype);
+        archetypeList.emplace_back(archetype);
+        // keep cached queries up to date
+        std::lock_guard<std::mutex> lock(queriesMutex);
+        for (const auto& query : queries) {
+            if (query) {
+                query->match(archetype);
+            }
+        }
+        return archetype;
+    }
+
+    Query& Registry::getQuery(u32 queryId, const archetype_signature& components) {
+        std::lock_guard<std::mutex> lock(queriesMutex);
+        if (queryId >= queries.size()) {
+            queries.resize(queryId + 1);
+        }
+
+        Scope<Query>& query = queries[queryId];
+        if (!query) {
+            query = createScope<Query>(components);
+            for (Archetype* archetype : archetypeList) {
+                query->match(archetype);
+            }
+        }
+        return *query;
+    }
+
+    void Registry::sortRows(Archetype* archetype, const vector<u32>& order) {
+        archetype->permute(order);
+        for (u32 c = 0 ; c < archetype->chunks.size() ; c++) {
+            const ArchetypeChunk& chunk = archetype->chunks[c];
+            entity_id* entityIds = archetype->getEntities(chunk);
+            for (u32 row = 0 ; row < chunk.size ; row++) {
+                entity& record = entities[entity_index(entityIds[row])];
+                record.chunk = c;
+                record.row = row;
+            }
+        }
+    }
+
+    static inline Archetype* getEdge(const vector<Archetype*>& edges, component_id componentId) {
+        return componentId < edges.size() ? edges[componentId] : nullptr;
+    }
+
+    static inline void setEdge(vector<Archetype*>& edges, component_id componentId, Archetype* archetype) {
+        if (componentId >= edges.size()) {
+            edges.resize(componentId + 1, nullptr);
+        }
+        edges[componentId] = archetype;
+    }
+
+    Archetype* Registry::getAddArchetype(Archetype* archetype, component_id componentId) {
+        Archetype* addArchetype = getEdge(archetype->addEdges, componentId);
+        if (addArchetype) {
+            return addArchetype;
+        }
 
-        auto* destComponent = (BaseComponent*)&data[componentIndex];
-        auto* srcComponent = (BaseComponent*)&data[srcIndex];
-        destroyFunction(destComponent);
+        archetype_signature signature = archetype->signature;
+        signature.insert(std::lower_bound(signature.begin(), signature.end(), componentId), componentId);
+        addArchetype = getArchetype(signature);
+        setEdge(archetype->addEdges, componentId, addArchetype);
+        setEdge(addArchetype->removeEdges, componentId, archetype);
+        return addArchetype;
+    }
 
-        if (componentIndex == srcIndex) {
-            free(&data[srcIndex]);
-            return;
+    Archetype* Registry::getRemoveArchetype(Archetype* archetype, component_id componentId) {
+        Archetype* removeArchetype = getEdge(archetype->removeEdges, componentId);
+        if (removeArchetype) {
+            return removeArchetype;
         }
 
-        memcpy(destComponent, srcComponent, typeSize);
+        archetype_signature signature = archetype->signature;
+        signature.erase(std::lower_bound(signature.begin(), signature.end(), componentId));
+        removeArchetype = getArchetype(signature);
+        setEdge(archetype->removeEdges, componentId, removeArchetype);
+        setEdge(removeArchetype->addEdges, componentId, archetype);
+        return removeArchetype;
+    }
+
+    void Registry::moveEntity(entity_id entityId, Archetype* archetype) {
+        entity* record = toEntity(entityId);
+        Archetype* oldArchetype = record->archetype;
+        u32 chunk, row;
+        archetype->allocate(entityId, chunk, row);
 
-        auto& entityData = toEntityData(srcComponent->entityId);
-        for (auto& componentIdAndIndex : entityData) {
-            if (componentId == componentIdAndIndex.first && srcIndex == componentIdAndIndex.second) {
-                componentIdAndIndex.second = componentIndex;
-                break;
+        // relocate shared components and destroy components that new archetype does not have
+        for (u32 i = 0 ; i < oldArchetype->signature.size() ; i++) {
+            component_id componentId = oldArchetype->signature[i];
+            u8* oldData = oldArchetype->getComponentData(record->chunk, record->row, i);
+            s32 column = archetype->getColumn(componentId);
+            if (column >= 0) {
+                oldArchetype->relocate(i, archetype->getComponentData(chunk, row, column), oldData);
+                const ArchetypeChunk& oldChunk = oldArchetype->chunks[record->chunk];
+                const ArchetypeChunk& newChunk = archetype->chunks[chunk];
+                archetype->getChangedVersions(newChunk, column)[row] = oldArchetype->getChangedVersions(oldChunk, i)[record->row];
+                archetype->getAddedVersions(newChunk, column)[row] = oldArchetype->getAddedVersions(oldChunk, i)[record->row];
+            } else {
+                logRemoved(componentId, entityId);
+                notifyRemoved(componentId, (BaseComponent*) oldData);
+                BaseComponent::getDestroyFunction(componentId)((BaseComponent*) oldData);
             }
         }
+        // release old row
+        entity_id movedEntityId = oldArchetype->deallocate(record->chunk, record->row);
+        if (movedEntityId != invalid_entity_id) {
+            toEntity(movedEntityId)->chunk = record->chunk;
+            toEntity(movedEntityId)->row = record->row;
+        }
 
-        data.resize(srcIndex);
+        record->archetype = archetype;
+        record->chunk = chunk;
+        record->row = row;
     }
 
     size_t Registry::entity_count() {
-        return entities.size();
+        return aliveCount;
     }
 
     bool Registry::empty_entity() {
-        return entities.empty();
+        return aliveCount == 0;
     }
 
     void Registry::clear() {
-        for (auto &component: components) {
-            auto typeSize = BaseComponent::getSize(component.first);
-            auto destroyFunction = BaseComponent::getDestroyFunction(component.first);
-            for (u32 i = 0; i < component.second.size(); i += typeSize) {
-                destroyFunction((BaseComponent *) &component.second[i]);
+        for (Archetype* archetype : archetypeList) {
+            for (u32 column = 0 ; column < archetype->signature.size() ; column++) {
+                component_id componentId = archetype->signature[column];
+                bool tracked = componentId < removedComponents.size() && removedComponents[componentId].tracked;
+                if (!tracked && !hasRemovedHook(componentId)) continue;
+                for (u32 c = 0 ; c < archetype->chunks.size() ; c++) {
+                    const ArchetypeChunk& chunk = archetype->chunks[c];
+                    for (u32 row = 0 ; row < chunk.size ; row++) {
+                        logRemoved(componentId, archetype->getEntities(chunk)[row]);
+                        notifyRemoved(componentId, (BaseComponent*) archetype->getComponentData(c, row, column));
+                    }
+                }
             }
+            archetype->clear();
+        }
+        archetypeList.clear();
+        archetypes.clear();
+        {
+            std::lock_guard<std::mutex> lock(queriesMutex);
+            for (const auto& query : queries) {
+                if (query) {
+                    query->clear();
+                }
+            }
+        }
+        // keep records, so handles created before clear() stay stale
+        freeEntity = invalid_entity_index;
+        for (u32 i = (u32) entities.size() ; i-- > 0 ;) {
+            if (entities[i].archetype) {
+                releaseRecord(entities[i]);
+            }
+            entities[i].nextFree = freeEntity;
+            freeEntity = i;
+        }
+        aliveCount = 0;
+        // recorded commands refer to entities that don't exist anymore
+        commandBuffers.clear();
+    }
+
+    void Registry::clone(Registry& target) {
+        clone(target, {});
+    }
+
+    void Registry::clone(Registry& target, const archetype_signature& skipped) {
+        ENGINE_ASSERT(&target != this, "clone() failed -> registry can't be cloned into itself!");
+        target.clear();
+        // versions of target never go back, so its change detection sees every copied component
+        target.version = std::max(version, target.version);
+
+        // archetypes without skipped components are copied chunk by chunk, others are merged row by row
+        unordered_map<Archetype*, Archetype*> targetArchetypes;
+        bool merged = false;
+        archetype_signature signature;
+        for (Archetype* archetype : archetypeList) {
+            signature.clear();
+            for (component_id componentId : archetype->signature) {
+                if (std::find(skipped.begin(), skipped.end(), componentId) == skipped.end()) {
+                    signature.emplace_back(componentId);
+                }
+            }
+            Archetype* targetArchetype = target.getArchetype(signature);
+            if (signature.size() == archetype->signature.size() && targetArchetype->entityCount == 0) {
+                archetype->copy(*targetArchetype, target.version);
+            } else {
+                archetype->copyRows(*targetArchetype, target.version);
+                merged = true;
+            }
+            targetArchetypes[archetype] = targetArchetype;
+        }
+
+        // records beyond this registry table or free in it keep the newest generation, so stale handles of both stay stale
+        vector<entity>& targetEntities = target.entities;
+        if (targetEntities.size() < entities.size()) {
+            targetEntities.resize(entities.size());
+        }
+        for (u32 i = 0 ; i < entities.size() ; i++) {
+            const entity& record = entities[i];
+            entity& targetRecord = targetEntities[i];
+            if (record.archetype) {
+                targetRecord = record;
+                targetRecord.archetype = targetArchetypes[record.archetype];
+            } else {
+                targetRecord.generation = std::max(record.generation, targetRecord.generation);
+            }
+        }
+        target.freeEntity = invalid_entity_index;
+        for (u32 i = (u32) targetEntities.size() ; i-- > 0 ;) {
+            if (!targetEntities[i].archetype) {
+                targetEntities[i].nextFree = target.freeEntity;
+                target.freeEntity = i;
+            }
+        }
+        target.aliveCount = aliveCount;
+
+        // rows of merged archetypes are moved, so their records point to new places
+        if (merged) {
+            for (Archetype* archetype : target.archetypeList) {
+                for (u32 c = 0 ; c < archetype->chunks.size() ; c++) {
+                    const ArchetypeChunk& chunk = archetype->chunks[c];
+                    entity_id* entityIds = archetype->getEntities(chunk);
+                    for (u32 row = 0 ; row < chunk.size ; row++) {
+                        entity& record = targetEntities[entity_index(entityIds[row])];
+                        record.chunk = c;
+                        record.row = row;
+                    }
+                }
+            }
+        }
+
+        // hooks are called when entity table is ready, so they can access any copied entity
+        for (Archetype* archetype : target.archetypeList) {
+            for (u32 column = 0 ; column < archetype->signature.size() ; column++) {
+                component_id componentId = archetype->signature[column];
+                if (!target.hasAddedHook(componentId)) continue;
+                for (u32 c = 0 ; c < archetype->chunks.size() ; c++) {
+                    for (u32 row = 0 ; row < archetype->chunks[c].size ; row++) {
+                        target.notifyAdded(componentId, (BaseComponent*) archetype->getComponentData(c, row, column));
+                    }
+                }
+            }
+        }
+    }
+
+    Scope<Registry> Registry::snapshot() {
+        Scope<Registry> snapshot = createScope<Registry>();
+        clone(*snapshot);
+        return snapshot;
+    }
+
+    // alignment of recorded components
+    constexpr component_size command_buffer_alignment = alignof(std::max_align_t);
+
+    CommandBuffer::~CommandBuffer() {
+        clear();
+    }
+
+    entity_id CommandBuffer::createEntity() {
+        Command command;
+        command.type = CREATE_ENTITY;
+        command.entityId = make_entity_id(++pendingCount, 0);
+        commands.emplace_back(command);
+        return command.entityId;
+    }
+
+    void CommandBuffer::deleteEntity(entity_id entityId) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "CommandBuffer::deleteEntity() failed -> invalid entity id!");
+        Command command;
+        command.type = DELETE_ENTITY;
+        command.entityId = entityId;
+        commands.emplace_back(command);
+    }
+
+    void* CommandBuffer::allocateComponent(component_size size) {
+        return components.allocate(size, command_buffer_alignment);
+    }
+
+    // moves recorded component into registry storage, so buffer doesn't destroy it on clear()
+    static void moveComponent(void* data, entity_id entityId, component_id componentId, BaseComponent*& component) {
+        auto relocateFunction = BaseComponent::getRelocateFunction(componentId);
+        if (relocateFunction) {
+            relocateFunction(data, component);
+        } else {
+            memcpy(data, component, BaseComponent::getSize(componentId));
+        }
+        ((BaseComponent*) data)->entityId = entityId;
+        component = nullptr;
+    }
+
+    void CommandBuffer::flush(Registry& registry) {
+        // entities created by this buffer go straight into their final archetype
+        flushPending(registry);
+
+        for (Command& command : commands) {
+            entity_id entityId = command.entityId;
+            if (isPending(entityId) || !registry.isAlive(entityId)) continue;
+
+            switch (command.type) {
+                case DELETE_ENTITY:
+                    registry.deleteEntity(entityId);
+                    break;
+                case ADD_COMPONENT: {
+                    void* data = registry.addComponentData(entityId, command.componentId);
+                    moveComponent(data, entityId, command.componentId, command.component);
+                    registry.notifyAdded(command.componentId, (BaseComponent*) data);
+                    break;
+                }
+                case REMOVE_COMPONENT:
+                    registry.removeComponent(entityId, command.componentId);
+                    break;
+                case UPDATE_COMPONENT:
+                    if (registry.toEntity(entityId)->archetype->contains(command.componentId)) {
+                        void* data = registry.addComponentData(entityId, command.componentId);
+                        moveComponent(data, entityId, command.componentId, command.component);
+                        registry.notifyAdded(command.componentId, (BaseComponent*) data);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        clear();
+    }
+
+    void CommandBuffer::flushPending(Registry& registry) {
+        if (pendingCount == 0) return;
+
+        // resolve final set of components for each pending entity: component id -> index of command with its value
+        vector<vector<std::pair<component_id, u32>>> pendingComponents(pendingCount + 1);
+        vector<bool> deleted(pendingCount + 1, false);
+        for (u32 i = 0 ; i < commands.size() ; i++) {
+            const Command& command = commands[i];
+            if (!isPending(command.entityId)) continue;
+
+            u32 pendingIndex = entity_index(command.entityId);
+            ENGINE_ASSERT(pendingIndex <= pendingCount, "CommandBuffer::flush() failed -> pending entity was created by another buffer!");
+            auto& components = pendingComponents[pendingIndex];
+            auto it = std::find_if(components.begin(), components.end(), [&command](const std::pair<component_id, u32>& component) {
+                return component.first == command.componentId;
+            });
+            switch (command.type) {
+                case DELETE_ENTITY:
+                    deleted[pendingIndex] = true;
+                    components.clear();
+                    break;
+                case ADD_COMPONENT:
+                    if (it != components.end()) {
+                        it->second = i;
+                    } else {
+                        components.emplace_back(command.componentId, i);
+                    }
+                    break;
+                case REMOVE_COMPONENT:
+                    if (it != components.end()) {
+                        components.erase(it);
+                    }
+                    break;
+                case UPDATE_COMPONENT:
+                    if (it != components.end()) {
+                        it->second = i;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // find archetype of each entity and reserve storage once per archetype
+        vector<Archetype*> archetypes(pendingCount + 1, nullptr);
+        unordered_map<Archetype*, u32> archetypeCounts;
+        u32 createCount = 0;
+        for (u32 i = 1 ; i <= pendingCount ; i++) {
+            if (deleted[i]) continue;
+
+            auto& components = pendingComponents[i];
+            std::sort(components.begin(), components.end());
+            archetype_signature signature;
+            signature.reserve(components.size());
+            for (const auto& component : components) {
+                signature.emplace_back(component.first);
+            }
+            archetypes[i] = registry.getArchetype(signature);
+            archetypeCounts[archetypes[i]]++;
+            createCount++;
+        }
+        registry.entities.reserve(registry.entities.size() + createCount);
+        for (const auto& archetypeCount : archetypeCounts) {
+            archetypeCount.first->reserve(archetypeCount.second);
+        }
+
+        // create entities in the order they were recorded
+        for (u32 i = 1 ; i <= pendingCount ; i++) {
+            Archetype* archetype = archetypes[i];
+            if (!archetype) continue;
+
+            entity_id entityId = registry.createEntity(archetype);
+            entity* record = registry.toEntity(entityId);
+            const auto& components = pendingComponents[i];
+            for (u32 column = 0 ; column < components.size() ; column++) {
+                Command& command = commands[components[column].second];
+                void* data = archetype->getComponentData(record->chunk, record->row, column);
+                moveComponent(data, entityId, command.componentId, command.component);
+                registry.stampAdded(record, column);
+            }
+            // hooks may read other components of entity, so they are called after all of them are constructed
+            for (u32 column = 0 ; column < components.size() ; column++) {
+                component_id componentId = commands[components[column].second].componentId;
+                registry.notifyAdded(componentId, (BaseComponent*) archetype->getComponentData(record->chunk, record->row, column));
+            }
+        }
+    }
+
+    void CommandBuffer::clear() {
+        for (const Command& command : commands) {
+            if (command.component) {
+                BaseComponent::getDestroyFunction(command.componentId)(command.component);
+            }
+        }
+        commands.clear();
+        pendingCount = 0;
+        components.reset();
+    }
+
+    static std::atomic<u64> commandBuffersCounter { 0 };
+
+    CommandBuffers::CommandBuffers() : id(++commandBuffersCounter) {}
+
+    CommandBuffer& CommandBuffers::get() {
+        // remember last used buffer of thread, so lock is taken only when thread switches registry
+        thread_local u64 cachedId = 0;
+        thread_local CommandBuffer* cachedBuffer = nullptr;
+        if (cachedId == id) {
+            return *cachedBuffer;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& buffer = threadBuffers[std::this_thread::get_id()];
+        if (!buffer) {
+            buffer = createScope<CommandBuffer>();
+            buffers.emplace_back(buffer.get());
+        }
+        cachedId = id;
+        cachedBuffer = buffer.get();
+        return *cachedBuffer;
+    }
+
+    void CommandBuffers::flush(Registry& registry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (CommandBuffer* buffer : buffers) {
+            if (!buffer->empty()) {
+                buffer->flush(registry);
+            }
+        }
+    }
+
+    void CommandBuffers::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (CommandBuffer* buffer : buffers) {
+            buffer->clear();
         }
-        components.clear();
-        entities.clear();
     }
-}
\ No newline at end of file
+}
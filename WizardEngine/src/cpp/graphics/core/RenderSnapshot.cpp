@@ -0,0 +1,53 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <graphics/core/RenderSnapshot.h>
+#include <graphics/core/RenderSystem.h>
+#include <profiler/Profiler.h>
+#include <scripting/ScriptComponents.h>
+#include <physics/Colliders.h>
+#include <audio/audio_source.h>
+#include <audio/audio_listener.h>
+
+namespace engine::graphics {
+
+    RenderSnapshot::RenderSnapshot() {
+        buffers[0] = createRef<Scene>("RenderSnapshot");
+        buffers[1] = createRef<Scene>("RenderSnapshot");
+        skip<UUIDComponent, TagComponent>();
+        skip<scripting::NativeScript, scripting::CppScript>();
+        skip<physics::CollisionTransform, physics::SphereCollider, physics::AABBCollider, physics::PlaneCollider, physics::Velocity>();
+        skip<audio::AudioSourceComponent, audio::AudioListenerComponent, audio::Orientation>();
+    }
+
+    void RenderSnapshot::extract(Scene& scene) {
+        PROFILE_FUNCTION();
+        Scene& back = *buffers[front ^ 1];
+        Registry& registry = scene.getRegistry();
+        // entity ids are kept by clone(), so handles only need to be rebound to back buffer
+        registry.clone(back.getRegistry(), skipped);
+
+        Camera3D camera = scene.getCamera();
+        camera.setContainer(&back);
+        back.setCamera(camera);
+        back.setSkybox(Entity(&back, scene.getSkybox().getId()));
+        back.setHdrEnv(Entity(&back, scene.getHdrEnv().getId()));
+
+        RenderSystem::onExtract(registry);
+        extracted = true;
+    }
+
+    void RenderSnapshot::swap() {
+        if (!extracted) return;
+        front ^= 1;
+        extracted = false;
+    }
+
+    void RenderSnapshot::clear() {
+        buffers[0]->clear();
+        buffers[1]->clear();
+        extracted = false;
+    }
+
+}
@@ -62,6 +62,10 @@ namespace engine::graphics {
     }
 
     void RenderSystem::onUpdate() {
+        onUpdate(*activeScene);
+    }
+
+    void RenderSystem::onUpdate(Scene& scene) {
         PROFILE_FUNCTION();
 
 //        shadowsFrame->setViewPort();
@@ -97,7 +101,7 @@ namespace engine::graphics {
         setStencilTestOperator(TestOperator::ALWAYS, 1, false);
         setStencilMask(0xFF);
 
-        auto& registry = activeScene->getRegistry();
+        auto& registry = scene.getRegistry();
         // scene
         batchRenderer->render(registry);
         instanceRenderer->render(registry);
@@ -128,7 +132,7 @@ namespace engine::graphics {
         setDepthTestOperator(TestOperator::LESS_EQUAL); // we need to pass depth test for some skybox pixels
         // todo HDR env not working yet
 //        hdrEnvRenderer.render(activeScene->getHdrEnv(), activeScene->getCamera());
-        skyboxRenderer.render(activeScene->getSkybox(), activeScene->getCamera());
+        skyboxRenderer.render(scene.getSkybox(), scene.getCamera());
         setDepthTestOperator(TestOperator::LESS);
         // notify that scene frame end drawing
         if (callback != nullptr) {
@@ -138,8 +142,8 @@ namespace engine::graphics {
             // read/write from MSAA frame into scene frame
             FrameBuffer::readWriteFrameBuffers(*msaaFrame.get(), *sceneFrame.get());
         }
-        // post-processing effects
-        vector<u32> postProcessedTextures;
+        // post-processing effects, list lives only in this frame
+        frame_vector<u32> postProcessedTextures;
         // render target 1 without post effects
         ColorAttachment sceneTexture1;
         sceneFrame->getColorAttachment(0, sceneTexture1);
@@ -172,6 +176,21 @@ namespace engine::graphics {
 #endif
     }
 
+    void RenderSystem::onExtract(Registry& registry) {
+        PROFILE_FUNCTION();
+        batchRenderer->onExtract(registry);
+        instanceRenderer->onExtract(registry);
+        for (const auto& sceneRenderer : sceneRenderers) {
+            sceneRenderer->onExtract(registry);
+        }
+        for (const auto& outlineRenderer : outlineRenderers) {
+            outlineRenderer->onExtract(registry);
+        }
+        for (const auto& textRenderer : textRenderers) {
+            textRenderer->onExtract(registry);
+        }
+    }
+
     void RenderSystem::setRenderSystemCallback(RenderSystemCallback* renderSystemCallback) {
         callback = renderSystemCallback;
     }
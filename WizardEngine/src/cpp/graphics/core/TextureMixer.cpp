@@ -17,7 +17,7 @@ namespace engine::graphics {
         frameBuffer->updateFormat(frameBufferFormat);
     }
 
-    u32 TextureMixer::render(const vector<u32> &textures) {
+    u32 TextureMixer::render(const frame_vector<u32> &textures) {
         frameBuffer->bind();
         shaderProgram.start();
 
@@ -13,10 +13,12 @@ namespace engine::io {
     }
 
     const std::string& ShaderFile::readShader(const std::string &filepath) {
-        if (s_ShadersStorage.find(filepath) == s_ShadersStorage.end()) {
-            s_ShadersStorage[filepath] = filesystem::readWithIncludes(filepath, "#include");
+        // source is valid until next shader is read, so callers copy it
+        auto it = s_ShadersStorage.find(filepath);
+        if (it == s_ShadersStorage.end()) {
+            it = s_ShadersStorage.emplace(filepath, filesystem::readWithIncludes(filepath, "#include")).first;
         }
-        return s_ShadersStorage.at(filepath);
+        return it->second;
     }
 
     void ShaderFile::clear() {
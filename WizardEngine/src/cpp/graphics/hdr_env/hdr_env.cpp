@@ -56,17 +56,17 @@ namespace engine::graphics {
     }
 
     void HdrEnvRenderer::upload(HdrEnv* hdrEnv) {
-        auto geometry = hdrEnv->geometry;
-        if (geometry.vertexData.values) {
+        auto& geometry = hdrEnv->geometry;
+        if (geometry.isUpdated) {
             ENGINE_INFO("uploadStatic HDR env to renderer");
             if (!renderModel.hasCapacity(geometry)) {
-                renderModel = { 0, geometry.vertexData.size };
+                renderModel = { 0, geometry.vertexData.size() };
                 renderModel.vao.bind();
                 renderModel.vbo.setFormat(generateCubemapShader.getVertexFormat());
                 VertexArray::unbind();
             }
             renderModel.uploadStatic(geometry);
-            delete geometry.vertexData.values;
+            geometry.isUpdated = false;
         } else {
             ENGINE_WARN("HDR env is already uploaded!");
         }
@@ -101,7 +101,7 @@ namespace engine::graphics {
             graphics::clearBuffer(BufferBit::COLOR | BufferBit::DEPTH);
             // draw call
             renderModel.vao.bind();
-            drawV(hdrEnv->geometry.drawType, hdrEnv->geometry.vertexData.size);
+            drawV(hdrEnv->geometry.drawType, hdrEnv->geometry.vertexData.size());
         }
         generateCubemapShader.stop();
 
@@ -126,7 +126,7 @@ namespace engine::graphics {
         cubemapShader.setUniform(hdrEnv->transform.modelMatrix);
         // draw call
         renderModel.vao.bind();
-        drawV(hdrEnv->geometry.drawType, hdrEnv->geometry.vertexData.size);
+        drawV(hdrEnv->geometry.drawType, hdrEnv->geometry.vertexData.size());
         cubemapShader.stop();
     }
 }
\ No newline at end of file
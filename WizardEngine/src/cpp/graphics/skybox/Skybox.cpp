@@ -42,17 +42,17 @@ namespace engine::graphics {
     }
 
     void SkyboxRenderer::upload(Skybox* skybox) {
-        auto skyboxGeometry = skybox->geometry;
-        if (skyboxGeometry.vertexData.values) {
+        auto& skyboxGeometry = skybox->geometry;
+        if (skyboxGeometry.isUpdated) {
             ENGINE_INFO("uploadStatic skybox to renderer");
-            if (!renderModel.hasCapacity(skybox->geometry)) {
-                renderModel = { 0, skybox->geometry.vertexData.size };
+            if (!renderModel.hasCapacity(skyboxGeometry)) {
+                renderModel = { 0, skyboxGeometry.vertexData.size() };
                 renderModel.vao.bind();
                 renderModel.vbo.setFormat(shaderProgram.getVertexFormat());
                 VertexArray::unbind();
             }
-            renderModel.uploadStatic(skybox->geometry);
-            delete skyboxGeometry.vertexData.values;
+            renderModel.uploadStatic(skyboxGeometry);
+            skyboxGeometry.isUpdated = false;
         } else {
             ENGINE_WARN("Skybox is already uploaded!");
         }
@@ -75,7 +75,7 @@ namespace engine::graphics {
         shaderProgram.setUniform(skybox->transform.modelMatrix);
         // draw call
         renderModel.vao.bind();
-        drawV(skybox->geometry.drawType, skybox->geometry.vertexData.size);
+        drawV(skybox->geometry.drawType, skybox->geometry.vertexData.size());
         shaderProgram.stop();
     }
 
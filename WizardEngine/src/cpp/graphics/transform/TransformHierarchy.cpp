@@ -0,0 +1,143 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <graphics/transform/TransformHierarchy.h>
+#include <profiler/Profiler.h>
+#include <core/Application.h>
+
+namespace engine::graphics {
+
+    Ref<Scene> TransformHierarchy::activeScene;
+    Scene* TransformHierarchy::updatedScene = nullptr;
+    component_version TransformHierarchy::updatedVersion = 0;
+
+    void TransformHierarchy::setParent(Registry& registry, entity_id child, entity_id parent) {
+        ENGINE_ASSERT(child != parent, "setParent() failed -> entity can't be a parent of itself!");
+
+        if (!registry.hasComponent<HierarchyComponent>(child)) {
+            registry.addComponent<HierarchyComponent>(child);
+        }
+        if (parent != invalid_entity_id && !registry.hasComponent<HierarchyComponent>(parent)) {
+            registry.addComponent<HierarchyComponent>(parent);
+        }
+        // components are taken after adding, because adding moves entity storage
+        auto* childHierarchy = registry.getComponent<HierarchyComponent>(child);
+
+        // unlink from old parent
+        entity_id oldParent = childHierarchy->parent;
+        if (oldParent != invalid_entity_id && registry.isAlive(oldParent)) {
+            auto* oldParentHierarchy = registry.getComponent<HierarchyComponent>(oldParent);
+            if (oldParentHierarchy) {
+                auto& children = oldParentHierarchy->children;
+                children.erase(std::remove(children.begin(), children.end(), child), children.end());
+            }
+        }
+
+        u32 depth = 0;
+        if (parent != invalid_entity_id) {
+            auto* parentHierarchy = registry.getComponent<HierarchyComponent>(parent);
+            for (entity_id ancestor = parent ; ancestor != invalid_entity_id && registry.isAlive(ancestor) ;) {
+                ENGINE_ASSERT(ancestor != child, "setParent() failed -> parent is a descendant of child!");
+                auto* ancestorHierarchy = registry.getComponent<HierarchyComponent>(ancestor);
+                ancestor = ancestorHierarchy ? ancestorHierarchy->parent : invalid_entity_id;
+            }
+            parentHierarchy->children.emplace_back(child);
+            depth = parentHierarchy->depth + 1;
+        }
+
+        childHierarchy->parent = parent;
+        setDepth(registry, *childHierarchy, depth);
+        registry.markChanged<HierarchyComponent>(child);
+    }
+
+    void TransformHierarchy::setDepth(Registry& registry, HierarchyComponent& hierarchy, u32 depth) {
+        hierarchy.depth = depth;
+        for (entity_id child : hierarchy.children) {
+            if (!registry.isAlive(child)) continue;
+            auto* childHierarchy = registry.getComponent<HierarchyComponent>(child);
+            if (childHierarchy) {
+                setDepth(registry, *childHierarchy, depth + 1);
+            }
+        }
+    }
+
+    void TransformHierarchy::updateWorld(Registry& registry, entity_id entityId, bool localChanged) {
+        auto* hierarchy = registry.getComponent<HierarchyComponent>(entityId);
+        auto* transform = registry.getComponent<Transform3dComponent>(entityId);
+        if (transform && localChanged) {
+            transform->modelMatrix.apply();
+            hierarchy->localMatrix = transform->modelMatrix.value;
+        }
+
+        // parent may be already deleted, then entity behaves as a root
+        HierarchyComponent* parent = nullptr;
+        if (hierarchy->parent != invalid_entity_id && registry.isAlive(hierarchy->parent)) {
+            parent = registry.getComponent<HierarchyComponent>(hierarchy->parent);
+        }
+        // matrices are stored by columns, so local * parent gives parent * local transform
+        hierarchy->worldMatrix = parent ? hierarchy->localMatrix * parent->worldMatrix : hierarchy->localMatrix;
+
+        if (transform) {
+            transform->modelMatrix.value = hierarchy->worldMatrix;
+        }
+    }
+
+    void TransformHierarchy::onUpdate() {
+        PROFILE_FUNCTION();
+
+        auto& registry = activeScene->getRegistry();
+        if (registry.empty_components<HierarchyComponent>()) return;
+
+        // first update of scene recomputes everything
+        if (updatedScene != activeScene.get()) {
+            updatedScene = activeScene.get();
+            updatedVersion = 0;
+        }
+        component_version sinceVersion = updatedVersion;
+        component_version version = registry.nextVersion();
+        updatedVersion = version;
+
+        // entity ids by depth, with flag whether its local matrix is changed
+        vector<vector<std::pair<entity_id, bool>>> levels;
+        auto schedule = [&levels, version](HierarchyComponent* hierarchy, bool localChanged) {
+            if (hierarchy->updateVersion == version) return;
+            hierarchy->updateVersion = version;
+            if (hierarchy->depth >= levels.size()) {
+                levels.resize(hierarchy->depth + 1);
+            }
+            levels[hierarchy->depth].emplace_back(hierarchy->entityId, localChanged);
+        };
+
+        // only changed entities are scheduled, static ones cost nothing
+        registry.eachChanged<Transform3dComponent>(sinceVersion, [&registry, &schedule](Transform3dComponent* transform) {
+            auto* hierarchy = registry.getComponent<HierarchyComponent>(transform->entityId);
+            if (hierarchy) {
+                schedule(hierarchy, true);
+            }
+        });
+        registry.eachChanged<HierarchyComponent>(sinceVersion, [&schedule](HierarchyComponent* hierarchy) {
+            schedule(hierarchy, true);
+        });
+
+        // world matrices of level depend only on previous level, so each level is updated in parallel
+        for (u32 depth = 0 ; depth < levels.size() ; depth++) {
+            ThreadPoolScheduler->parallelFor(levels[depth].size(), hierarchy_grain, [&registry, &levels, depth](JobArgs args) {
+                const auto& entity = levels[depth][args.index];
+                updateWorld(registry, entity.first, entity.second);
+            });
+
+            // dirty flag goes down only to subtrees of updated entities
+            for (u32 i = 0 ; i < levels[depth].size() ; i++) {
+                auto* hierarchy = registry.getComponent<HierarchyComponent>(levels[depth][i].first);
+                for (entity_id child : hierarchy->children) {
+                    if (!registry.isAlive(child)) continue;
+                    auto* childHierarchy = registry.getComponent<HierarchyComponent>(child);
+                    if (childHierarchy) {
+                        schedule(childHierarchy, false);
+                    }
+                }
+            }
+        }
+    }
+}
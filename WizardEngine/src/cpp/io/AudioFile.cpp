@@ -142,7 +142,7 @@ namespace engine::io {
         open(filepath);
 
         AudioFormat format = readWavHeaders(filepath);
-        char* data = new char[format.size];
+        char* data = (char*) heap_allocator(MemoryTag::AUDIO).allocate(format.size);
         filestream.read(data, format.size);
 
         close();
@@ -150,6 +150,11 @@ namespace engine::io {
         return { format, data };
     }
 
+    void AudioFile::releaseWav(AudioData& audioData) {
+        heap_allocator(MemoryTag::AUDIO).deallocate(audioData.data, audioData.format.size);
+        audioData.data = nullptr;
+    }
+
     AudioFormat AudioFile::readWavHeaders(const char *filepath) {
         if (!isOpen()) {
             ENGINE_ERR("Unable to read file {0}. File is not opened!", filepath);
@@ -197,16 +202,13 @@ namespace engine::io {
         return filestream.is_open();
     }
 
-    char* AudioFile::streamWav(const s64& dataOffset, const s64& dataSize) {
+    void AudioFile::streamWav(char* data, const s64& dataOffset, const s64& dataSize) {
         if (!isOpen()) {
             ENGINE_THROW(file_not_found("Unable to stream file. File is not opened!"));
         }
 
-        char* data = new char[dataSize];
         filestream.seekg(dataOffset);
         filestream.read(data, dataSize);
-
-        return data;
     }
 
 }
\ No newline at end of file
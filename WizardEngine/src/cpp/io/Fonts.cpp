@@ -113,7 +113,7 @@ namespace engine::io {
             y += (fontSize + 2) - face->glyph->bitmap_top + maxUnderBaseline - 1;
             // store metrics data into Character struct
             vec2f imageSize = { static_cast<float>(imageWidth), static_cast<float>(imageHeight) };
-            auto* charVertices = new BatchCharVertex[4] {
+            auto charVertices = array<BatchCharVertex>({
                     BatchCharVertex { CharVertex {
                         { 0, 0 },
                         (vec2f { static_cast<f32>(x), static_cast<f32>(y) } * 2.0f - 1.0f) / (imageSize * 2.0f)
@@ -130,10 +130,9 @@ namespace engine::io {
                         { 0, 0 },
                         (vec2f { static_cast<float>(x), static_cast<float>(y + h) } * 2.0f - 1.0f) / (imageSize * 2.0f)
                     } }
-            };
-            auto charVertexData = array<BatchCharVertex> { charVertices, 0, 4 };
+            }, graphics_allocator());
             auto charVertexDataComponent = VertexDataComponent<BatchCharVertex>();
-            charVertexDataComponent.vertexData = charVertexData;
+            charVertexDataComponent.vertexData = std::move(charVertices);
             auto character = Character {
                 charVertexDataComponent,
                 vec2f { static_cast<float>(w), static_cast<float>(h) } / imageSize,
@@ -143,10 +142,10 @@ namespace engine::io {
             // map char and appropriate Character struct
             characters.insert(std::pair<char, Character>(i, character));
             ENGINE_INFO("Fonts : mapping char '{0}' into Character : ", i);
-            for (int j = 0; j < charVertexData.size; j++) {
+            for (const auto& charVertex : charVertexDataComponent.vertexData) {
                 ENGINE_INFO("CharVertex[x : {0}, y : {1}]",
-                            charVertices[j].vertex.uv.x(),
-                            charVertices[j].vertex.uv.y());
+                            charVertex.vertex.uv.x(),
+                            charVertex.vertex.uv.y());
             }
             ENGINE_INFO("Character[size : {0} , {1}]", character.size.x(), character.size.y());
             // draw the character
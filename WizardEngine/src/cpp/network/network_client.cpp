@@ -31,15 +31,16 @@ namespace engine::network {
             senderTask.name = "TCPSender_Task";
             senderTask.threadName = "TCPSender_Thread";
             senderTask.runnable = [this]() { runImpl(); };
+            senderTask.isLongLived = true;
             senderTask.run();
         }
 
         void Sender::stop() {
-            senderTask.isRunning = false;
+            senderTask.stop();
         }
 
         void Sender::runImpl() {
-            while (senderTask.isRunning) {
+            while (senderTask.isRunning()) {
                 if (requestQueue.empty()) {
                     continue;
                 }
@@ -75,11 +76,12 @@ namespace engine::network {
             receiverTask.name = "TCPReceiver_Task";
             receiverTask.threadName = "TCPReceiver_Thread";
             receiverTask.runnable = [this]() { runImpl(); };
+            receiverTask.isLongLived = true;
             receiverTask.run();
         }
 
         void Receiver::stop() {
-            receiverTask.isRunning = false;
+            receiverTask.stop();
         }
 
         void Receiver::close() {
@@ -90,7 +92,7 @@ namespace engine::network {
         void Receiver::runImpl() {
             char data[kb_1];
 
-            while (receiverTask.isRunning) {
+            while (receiverTask.isRunning()) {
                 memset(data, 0, kb_1);
                 s32 receivedSize = ::recv(clientSocket, data, kb_1,0);
 
@@ -115,7 +117,13 @@ namespace engine::network {
             }
         }
 
-        Client::Client() {
+        Client::Client() : connectTask(
+                "TCPConnect_Task",
+                "TCPConnect_Thread",
+                [this](const std::string& ip, const int& port) { connectImpl(ip, port); },
+                [](){},
+                true
+        ) {
             clientSocket = socket::open(AF_INET, SOCK_STREAM, 0);
             if (clientSocket == INVALID_SOCKET) {
                 u32 errorCode = socket::getLastError();
@@ -127,6 +135,12 @@ namespace engine::network {
 
         void Client::close() {
             connecting = false;
+            {
+                std::lock_guard<std::mutex> lock(retryMutex);
+                thread::taskExecutor().cancelTimer(retryTimer);
+                retryTimer = {};
+            }
+            connectTask.stop();
             sender->close();
             receiver->close();
             socket::close_socket(clientSocket);
@@ -136,8 +150,9 @@ namespace engine::network {
         }
 
         void Client::connect(const std::string &ip, int port) {
-            if (!connecting) {
-                std::async(std::launch::async, &Client::connectImpl, this, ip, port);
+            bool expected = false;
+            if (connecting.compare_exchange_strong(expected, true)) {
+                connectTask.run(ip, port);
             }
         }
 
@@ -147,7 +162,6 @@ namespace engine::network {
 
         void Client::connectImpl(const std::string &ip, int port) {
             ENGINE_INFO("TCP_Client: connecting to a server[ip:{0}, port:{1}]", ip, port);
-            connecting = true;
             s32 connection = socket::connect(clientSocket, AF_INET, ip.c_str(), port);
             // handle connection error and retry to connect!
             if (connection == SOCKET_ERROR) {
@@ -165,10 +179,18 @@ namespace engine::network {
                         break;
                 }
 
+                // close() cancels retry, unless it's already running, so retry checks that client is still connecting
+                // timer only starts next attempt, as blocking connect must not hold executor worker
+                std::lock_guard<std::mutex> lock(retryMutex);
+                if (!connecting) return;
                 u32 retrySleepMs = 2000;
                 ENGINE_WARN("TCP_Client: Retry to connect to a server after {0} ms!", retrySleepMs);
-                thread::current_sleep(retrySleepMs);
-                connectImpl(ip, port);
+                retryTimer = thread::taskExecutor().executeAfter(std::chrono::milliseconds(retrySleepMs), [this, ip, port]() {
+                    if (connecting) {
+                        connectTask.run(ip, port);
+                    }
+                });
+                return;
             }
             sender->run(clientSocket);
             receiver->run(clientSocket);
@@ -183,11 +205,12 @@ namespace engine::network {
             senderTask.name = "UDPSender_Task";
             senderTask.threadName = "UDPSender_Thread";
             senderTask.runnable = [this]() { runImpl(); };
+            senderTask.isLongLived = true;
             senderTask.run();
         }
 
         void Sender::stop() {
-            senderTask.isRunning = false;
+            senderTask.stop();
         }
 
         void Sender::close() {
@@ -196,7 +219,7 @@ namespace engine::network {
         }
 
         void Sender::runImpl() {
-            while (senderTask.isRunning) {
+            while (senderTask.isRunning()) {
                 if (requestQueue.empty()) {
                     continue;
                 }
@@ -233,11 +256,12 @@ namespace engine::network {
             receiverTask.name = "UDPReceiver_Task";
             receiverTask.threadName = "UDPReceiver_Thread";
             receiverTask.runnable = [this]() { runImpl(); };
+            receiverTask.isLongLived = true;
             receiverTask.run();
         }
 
         void Receiver::stop() {
-            receiverTask.isRunning = false;
+            receiverTask.stop();
         }
 
         void Receiver::runImpl() {
@@ -245,7 +269,7 @@ namespace engine::network {
             memset(&server, 0, serverLength);
             char data[kb_1];
 
-            while (receiverTask.isRunning) {
+            while (receiverTask.isRunning()) {
                 memset(data, 0, kb_1);
                 s32 receivedSize = socket::receiveFrom(clientSocket, data, kb_1,0, server);
 
@@ -59,7 +59,9 @@ namespace engine::network {
         thread::VoidTask<const s32&> Server::listenTask = {
                 "TCPServerListen_Task",
                 "TCPServerListen_Thread",
-                listenImpl
+                listenImpl,
+                [](){},
+                true
         };
 
         ServerListener* Server::listener = nullptr;
@@ -81,7 +83,7 @@ namespace engine::network {
         }
 
         void Server::close() {
-            listenTask.isRunning = false;
+            listenTask.stop();
             socket::close_socket(clientProfile.socket);
             listener->onTCPSocketClosed();
             delete clientProfile.host;
@@ -114,7 +116,7 @@ namespace engine::network {
         void Server::runImpl() {
             char data[kb_4];
 
-            while (listenTask.isRunning) {
+            while (listenTask.isRunning()) {
                 memset(data, 0, kb_4);
                 // receive data from client
                 s32 receivedSize = recv(clientProfile.socket, data, kb_4, 0);
@@ -151,7 +153,7 @@ namespace engine::network {
         }
 
         void Server::stop() {
-            listenTask.isRunning = false;
+            listenTask.stop();
         }
 
         void TCPSceneService::init(SOCKET socket) {
@@ -172,7 +174,9 @@ namespace engine::network {
         thread::VoidTask<const s32&> Server::listenTask = {
                 "UDPServerConnection_Task",
                 "UDPServerConnection_Thread",
-                listenImpl
+                listenImpl,
+                [](){},
+                true
         };
 
         ServerListener* Server::listener = nullptr;
@@ -194,7 +198,7 @@ namespace engine::network {
         }
 
         void Server::close() {
-            listenTask.isRunning = false;
+            listenTask.stop();
             socket::close_socket(clientSocket);
             listener->onUDPSocketClosed();
         }
@@ -225,7 +229,7 @@ namespace engine::network {
             char data[kb_1];
             sceneService.init(clientSocket, client);
 
-            while (listenTask.isRunning) {
+            while (listenTask.isRunning()) {
                 memset(data, 0, kb_1);
                 s32 receivedSize = socket::receiveFrom(clientSocket, data, kb_1,0, client);
                 if (receivedSize == SOCKET_ERROR) {
@@ -261,7 +265,7 @@ namespace engine::network {
         }
 
         void Server::stop() {
-            listenTask.isRunning = false;
+            listenTask.stop();
         }
 
         void Server::send(char *data, size_t size) {
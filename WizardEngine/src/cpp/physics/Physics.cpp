@@ -5,6 +5,7 @@
 #include <physics/Physics.h>
 #include <graphics/transform/TransformComponents.h>
 #include <profiler/Profiler.h>
+#include <core/Application.h>
 
 namespace engine::physics {
 
@@ -45,12 +46,14 @@ namespace engine::physics {
             handleIntersectData(Intersections::intersect(*plane1, *plane2), registry, plane1->entityId, plane2->entityId);
         });
         // simulation
-        registry.each<Transform3dComponent, Velocity>([&dt, &registry](
+        // each entity touches only its own components here, so integration is split across thread pool
+        registry.parallelEach<Transform3dComponent, Velocity>(*ThreadPoolScheduler, simulation_grain, [&dt, &registry](
                 Transform3dComponent* transform,
                 Velocity* velocity
         ) {
             transform->modelMatrix.position += velocity->velocity * dt;
             transform->modelMatrix.apply();
+            registry.markChanged<Transform3dComponent>(transform->entityId);
 
             // simulate sphere colliders
             auto sphere = registry.getComponent<SphereCollider>(transform->entityId);
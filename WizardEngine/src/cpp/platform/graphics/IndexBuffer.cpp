@@ -47,8 +47,8 @@ namespace engine::graphics {
         glBufferSubData(
                 GL_ELEMENT_ARRAY_BUFFER,
                 (GLintptr)subDataOffset,
-                indexData.size * sizeof(u32),
-                indexData.values
+                indexData.size() * sizeof(u32),
+                indexData.data()
         );
     }
 
@@ -6,6 +6,7 @@
 
 #include <scripting/ScriptSystem.h>
 #include <profiler/Profiler.h>
+#include <core/Application.h>
 
 namespace engine::scripting {
 
@@ -23,7 +24,8 @@ namespace engine::scripting {
 
     void ScriptSystem::onUpdate(time::Time dt) {
         PROFILE_FUNCTION();
-        activeScene->getRegistry().each<NativeScript>([&dt](NativeScript* sc) {
+        // native scripts are updated in parallel, so they must not add or remove entities/components in onUpdate
+        activeScene->getRegistry().parallelEach<NativeScript>(*ThreadPoolScheduler, script_grain, [&dt](NativeScript* sc) {
             sc->onUpdateFunction(dt);
         });
         activeScene->getRegistry().each<CppScript>([&dt](CppScript* script) {
@@ -0,0 +1,21 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <thread/Task.h>
+
+#include <algorithm>
+
+namespace engine::thread {
+
+    TaskExecutor& taskExecutor() {
+        // tasks mostly wait for files, devices and sockets, so a few workers are enough
+        static TaskExecutor executor(
+                std::clamp(cpu_topology().physicalCount / 2, 1u, 4u),
+                ThreadFormat(ThreadPriority::NORMAL, "TaskWorker"),
+                false
+        );
+        return executor;
+    }
+
+}
@@ -1,5 +1,6 @@
 #include <thread/Thread.h>
 #include <platform/platform_detection.h>
+#include <io/Logger.h>
 
 #include <thread>
 #include <sstream>
@@ -7,6 +8,12 @@
 #ifdef WINDOWS
 #define NOMINMAX
 #include <Windows.h>
+#elif defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
 #endif
 
 namespace engine::thread {
@@ -16,7 +23,7 @@ namespace engine::thread {
     }
 
     u32 cpu_cores_count() {
-        return std::thread::hardware_concurrency();
+        return cpu_topology().logicalCount;
     }
 
     u32 currentThreadId() {
@@ -24,15 +31,81 @@ namespace engine::thread {
         return threadId;
     }
 
+#if defined(LINUX)
+    // returns -1, if value is not exposed, e.g. inside some containers
+    static s64 readCpuTopologyValue(u32 cpu, const char* name) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+        s64 value = -1;
+        if (!(file >> value)) {
+            return -1;
+        }
+        return value;
+    }
+#endif
+
+    static CpuTopology readCpuTopology() {
+        CpuTopology topology;
+
+#if defined(LINUX)
+
+        // process may be restricted to a subset of CPUs by taskset or cgroup cpuset
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+            std::unordered_set<u64> cores;
+            vector<u32> siblings;
+            for (u32 cpu = 0 ; cpu < CPU_SETSIZE ; cpu++) {
+                if (!CPU_ISSET(cpu, &allowed)) continue;
+                s64 package = readCpuTopologyValue(cpu, "physical_package_id");
+                s64 core = readCpuTopologyValue(cpu, "core_id");
+                // unknown layout, so each CPU is treated as a core
+                if (package < 0 || core < 0) {
+                    package = 0;
+                    core = cpu;
+                }
+                u64 coreKey = ((u64) package << 32) | (u32) core;
+                if (cores.insert(coreKey).second) {
+                    topology.cpus.emplace_back(cpu);
+                } else {
+                    siblings.emplace_back(cpu);
+                }
+            }
+            topology.physicalCount = (u32) cores.size();
+            topology.cpus.insert(topology.cpus.end(), siblings.begin(), siblings.end());
+            topology.logicalCount = (u32) topology.cpus.size();
+        }
+
+#endif
+
+        if (topology.cpus.empty()) {
+            topology.logicalCount = std::max(1u, std::thread::hardware_concurrency());
+            topology.physicalCount = topology.logicalCount;
+            for (u32 cpu = 0 ; cpu < topology.logicalCount ; cpu++) {
+                topology.cpus.emplace_back(cpu);
+            }
+        }
+
+        return topology;
+    }
+
+    const CpuTopology& cpu_topology() {
+        static const CpuTopology topology = readCpuTopology();
+        return topology;
+    }
+
     void setThreadFormat(u32 id, std::thread& thread, const ThreadFormat& format) {
+        const CpuTopology& topology = cpu_topology();
 
 #if defined(WINDOWS)
 
         HANDLE handle = (HANDLE)thread.native_handle();
         // set thread into dedicated core
-        DWORD_PTR affinityMask = 1ull << id;
-        DWORD_PTR affinity_result = SetThreadAffinityMask(handle, affinityMask);
-        assert(affinity_result > 0);
+        if (format.firstCpu >= 0) {
+            u32 cpu = topology.cpus[(format.firstCpu + id) % topology.cpus.size()];
+            DWORD_PTR affinityMask = 1ull << cpu;
+            DWORD_PTR affinity_result = SetThreadAffinityMask(handle, affinityMask);
+            assert(affinity_result > 0);
+        }
         // set priority
         int priority = THREAD_PRIORITY_NORMAL;
         switch (format.priority) {
@@ -56,25 +129,25 @@ namespace engine::thread {
 
 #elif defined(LINUX)
 
-        #define handle_error_en(en, msg) \
-               do { errno = en; perror(msg); } while (0)
-
-			int ret;
-			cpu_set_t cpuset;
-			CPU_ZERO(&cpuset);
-			size_t cpusetsize = sizeof(cpuset);
-
-			CPU_SET(threadID, &cpuset);
-			ret = pthread_setaffinity_np(worker.native_handle(), cpusetsize, &cpuset);
-			if (ret != 0)
-				handle_error_en(ret, std::string(" pthread_setaffinity_np[" + std::to_string(threadID) + ']').c_str());
-
-			// Name the thread
-			std::string thread_name = "wi::job::" + std::to_string(threadID);
-			ret = pthread_setname_np(worker.native_handle(), thread_name.c_str());
-			if (ret != 0)
-				handle_error_en(ret, std::string(" pthread_setname_np[" + std::to_string(threadID) + ']').c_str());
-#undef handle_error_en
+        pthread_t handle = thread.native_handle();
+        // set thread into dedicated core
+        if (format.firstCpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(topology.cpus[(format.firstCpu + id) % topology.cpus.size()], &cpuset);
+            int result = pthread_setaffinity_np(handle, sizeof(cpuset), &cpuset);
+            if (result != 0) {
+                ENGINE_WARN("setThreadFormat: failed to pin {0}-{1}, error: {2}", format.name, id, strerror(result));
+            }
+        }
+        // priority is not applied, raising it requires privileges for realtime scheduling policies
+        // set thread name, Linux limits it to 15 characters, so name is cut instead of id
+        std::string suffix = "-" + std::to_string(id);
+        std::string name = std::string(format.name).substr(0, 15 - std::min<size_t>(15, suffix.size())) + suffix;
+        int result = pthread_setname_np(handle, name.c_str());
+        if (result != 0) {
+            ENGINE_WARN("setThreadFormat: failed to name {0}, error: {1}", name, strerror(result));
+        }
 
 #endif
     }
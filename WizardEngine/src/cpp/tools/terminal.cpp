@@ -14,7 +14,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "VSCode_Task",
                 "VSCode_Thread",
-                openVSCode
+                openVSCode,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -30,7 +32,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "VSCode_Task",
                 "VSCode_Thread",
-                openNotepad
+                openNotepad,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -46,7 +50,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "VSCode_Task",
                 "VSCode_Thread",
-                openVisualStudio
+                openVisualStudio,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -62,7 +68,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "Photoshop_Task",
                 "Photoshop_Thread",
-                openPhotoshop
+                openPhotoshop,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -72,7 +80,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "Blender_Task",
                 "Blender_Thread",
-                openBlender
+                openBlender,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -82,7 +92,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "ZBrush_Task",
                 "ZBrush_Thread",
-                openZBrush
+                openZBrush,
+                [](){},
+                true
         };
         task.run(filePath);
     }
@@ -92,7 +104,9 @@ namespace engine::terminal {
         thread::VoidTask<const std::string&> task = {
                 "CMake_Task",
                 "CMake_Thread",
-                cmake
+                cmake,
+                [](){},
+                true
         };
         task.run(cmakePath);
     }
@@ -117,7 +117,7 @@ namespace engine::visual {
                         if (ImGui::IsKeyPressed(ImGuiKey_Enter))
                             entityRenameMode = false;
                     } else {
-                        bool headerOpened = ImGui::TreeNodeEx(entity.getId(), headerTreeFlags, "%s", tag.c_str());
+                        bool headerOpened = ImGui::TreeNodeEx((void*) (uintptr_t) entity.getId(), headerTreeFlags, "%s", tag.c_str());
                         if (ImGui::IsItemClicked()) {
                             _selectedEntity = entity;
                             _callback->onEntitySelected(_selectedEntity);
@@ -463,12 +463,14 @@ namespace engine::visual {
     }
 
     void drawTransformComponent(const ecs::Entity& entity) {
-        drawComponent<Transform3dComponent>("Transform", entity, [](graphics::Transform3dComponent& transform) {
+        drawComponent<Transform3dComponent>("Transform", entity, [&entity](graphics::Transform3dComponent& transform) {
             auto& model = transform.modelMatrix;
             drawVec3Controller("Translation", model.position);
             drawVec3Controller("Rotation", model.rotation);
             drawVec3Controller("Scale", model.scale, 1.0f);
             model.apply();
+            // lets TransformHierarchy update world matrices of children
+            entity.getContainer()->getRegistry().markChanged<Transform3dComponent>(entity.getId());
         });
     }
 
@@ -145,11 +145,13 @@ namespace engine::visual {
     }
 
     void Toolbar::onScenePlay() {
+        Application::get().requestSceneSnapshot();
         sceneState = SceneState::PLAY;
         isPaused = false;
     }
 
     void Toolbar::onSceneStop() {
+        Application::get().requestSceneRestore();
         sceneState = SceneState::EDIT;
         isPaused = true;
     }
@@ -159,6 +161,7 @@ namespace engine::visual {
     }
 
     void Toolbar::onSceneSimulate() {
+        Application::get().requestSceneSnapshot();
         sceneState = SceneState::SIMULATE;
         isPaused = false;
     }
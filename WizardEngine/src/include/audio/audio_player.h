@@ -8,6 +8,7 @@
 #include <audio/audio_source.h>
 #include <thread/Task.h>
 #include <core/map.h>
+#include <unordered_map>
 
 namespace engine::audio {
 
@@ -61,6 +62,7 @@ namespace engine::audio {
         static void stopImpl(const u32& sourceId);
 
         static void playStreamImpl(const u32& sourceId);
+        static void stopStream();
 
         static void loadStreamImpl(
                 const std::string& filepath,
@@ -71,10 +73,14 @@ namespace engine::audio {
     private:
         static LoadTask loadTask;
         static SourceTask playTask;
+        // stream is played until track ends, so it gets its own thread instead of blocking task executor
+        static SourceTask streamTask;
         static SourceTask manageTask;
 
-        static unordered_map<u32, Source> sources;
+        // node-based, as stream tasks hold references to their sources, while new sources are loaded
+        static std::unordered_map<u32, Source> sources;
         static u32 playedSourceId;
+        static u32 streamedSourceId;
     };
 
 }
@@ -11,6 +11,9 @@ namespace engine::audio {
 
     using namespace core;
 
+    // size of single streamed buffer
+    constexpr size_t audio_stream_buffer_size = kb_512;
+
     struct ENGINE_API Cursor final {
         u8 bufferCount = 0;
         size_t bufferSize = 0;
@@ -9,6 +9,7 @@
 #include <core/Memory.h>
 #include <core/ProjectManager.h>
 #include <core/job_system.h>
+#include <core/frame_allocator.h>
 
 #include <time/Time.h>
 
@@ -24,6 +25,7 @@
 #include <platform/graphics/tools/VideoStats.h>
 
 #include <graphics/core/RenderSystem.h>
+#include <graphics/core/RenderSnapshot.h>
 #include <graphics/core/sources/ShaderSource.h>
 #include <graphics/core/io/ModelFile.h>
 #include <graphics/core/geometry/Point.h>
@@ -50,6 +52,10 @@
 
 #include <physics/Physics.h>
 
+#include <graphics/transform/TransformHierarchy.h>
+
+#include <ecs/SystemScheduler.h>
+
 #include <thread/Thread.h>
 
 #define Jobs engine::core::Application::get().jobSystem
@@ -160,6 +166,10 @@ namespace engine::core {
         void setSampleSize(int samples);
 
         void setActiveScene(const Ref<Scene>& activeScene);
+        // edit snapshot of active scene is taken on play and restored on stop
+        // requests are applied at frame sync point, when systems don't iterate the scene
+        void requestSceneSnapshot();
+        void requestSceneRestore();
 
         void loadGamepadMappings(const char* mappingsFilePath);
 
@@ -172,6 +182,9 @@ namespace engine::core {
         void restart();
 
         void update();
+        void updatePipelined();
+        void applySnapshotRequest();
+        void createSimulationSystems();
         void onSimulationUpdate();
         void onEventUpdate();
 
@@ -198,6 +211,10 @@ namespace engine::core {
 
     public:
         Scope<JobSystem<>> jobSystem;
+        // simulation systems of active scene, run by thread pool each frame
+        SystemScheduler simulationSystems;
+        // scene copy rendered while next frame is simulated, used when projectProps.renderLatency is 1
+        RenderSnapshot renderSnapshot;
         Ref<Scene> activeScene = nullptr;
         Ref<FrameBuffer> activeSceneFrame;
         Ref<FrameBuffer> msaaFrame;
@@ -219,8 +236,15 @@ namespace engine::core {
         ProjectProps projectProps;
 
     private:
+        enum class SnapshotRequest : u8 {
+            NONE, TAKE, RESTORE
+        };
+
         static Application* instance;
         bool _isRunning = true;
+        // set by ImGui tools on render thread, applied by main thread
+        std::atomic<SnapshotRequest> snapshotRequest = SnapshotRequest::NONE;
+        Scope<Registry> editSnapshot;
         // core systems
         Scope<Window> m_Window;
     };
@@ -3,7 +3,14 @@
 //
 #pragma once
 
+#include <core/core.h>
+#include <core/primitives.h>
+#include <core/immutable.h>
+#include <core/vector.h>
+
 #include <memory>
+#include <mutex>
+#include <cstddef>
 
 namespace engine::core {
 
@@ -31,4 +38,286 @@ namespace engine::core {
         return std::weak_ptr<T>(std::forward<Args>(args)...);
     }
 
-}
\ No newline at end of file
+    // Allocators
+
+    constexpr size_t default_alignment = alignof(std::max_align_t);
+
+    // subsystem, which memory is accounted to
+    enum class MemoryTag : u8 {
+        GENERAL = 0,
+        ECS,
+        GRAPHICS,
+        AUDIO,
+        NETWORK
+    };
+    constexpr u32 memory_tag_count = 5;
+
+    ENGINE_API const char* memory_tag_name(MemoryTag tag);
+
+    struct ENGINE_API MemoryStats {
+        size_t allocated = 0; // bytes currently taken from system
+        size_t peak = 0;
+        size_t allocations = 0; // live allocations
+    };
+
+    // counts memory, which tagged allocators take from system, it's thread safe
+    // pools and arenas take their pages through heap_allocator(), so they are counted by pages
+    class ENGINE_API MemoryTracker final {
+
+    public:
+        static void onAllocate(MemoryTag tag, size_t size);
+        static void onDeallocate(MemoryTag tag, size_t size);
+        static MemoryStats getStats(MemoryTag tag);
+        // logs stats of each tag
+        static void log();
+    };
+
+    // base of engine allocators, deallocate() must get the same size and alignment as allocate()
+    class ENGINE_API Allocator {
+
+    public:
+        explicit Allocator(MemoryTag tag = MemoryTag::GENERAL) : m_Tag(tag) {}
+        virtual ~Allocator() = default;
+
+    public:
+        virtual void* allocate(size_t size, size_t alignment = default_alignment) = 0;
+        virtual void deallocate(void* memory, size_t size, size_t alignment = default_alignment) = 0;
+
+        [[nodiscard]] inline MemoryTag getTag() const {
+            return m_Tag;
+        }
+
+    protected:
+        MemoryTag m_Tag;
+    };
+
+    // system heap with any alignment, it's thread safe and tracked by MemoryTracker
+    class ENGINE_API AlignedAllocator final : public Allocator {
+
+    public:
+        explicit AlignedAllocator(MemoryTag tag = MemoryTag::GENERAL) : Allocator(tag) {}
+
+    public:
+        void* allocate(size_t size, size_t alignment = default_alignment) override;
+        void deallocate(void* memory, size_t size, size_t alignment = default_alignment) override;
+    };
+
+    // shared heap allocator of subsystem, it's never destroyed, so static objects may release memory into it
+    ENGINE_API Allocator& heap_allocator(MemoryTag tag = MemoryTag::GENERAL);
+
+    // Fixed-size blocks, carved from pages of upstream allocator.
+    // Released blocks are linked into free list and reused first, pages are returned only with pool.
+    // It's thread safe.
+    class ENGINE_API PoolAllocator final : public Allocator {
+
+    public:
+        PoolAllocator(size_t blockSize, size_t blockAlignment, u32 blocksPerPage, Allocator& upstream = heap_allocator());
+        ~PoolAllocator() override;
+
+        IMMUTABLE(PoolAllocator)
+
+    public:
+        // size and alignment can't be bigger than pool block
+        void* allocate(size_t size, size_t alignment = default_alignment) override;
+        void deallocate(void* memory, size_t size, size_t alignment = default_alignment) override;
+
+        [[nodiscard]] inline size_t getBlockSize() const {
+            return m_BlockSize;
+        }
+
+        [[nodiscard]] size_t getUsedBlocks();
+        [[nodiscard]] size_t getPageCount();
+
+    private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        std::mutex m_Mutex;
+        Allocator& m_Upstream;
+        size_t m_BlockSize;
+        size_t m_BlockAlignment;
+        u32 m_BlocksPerPage;
+        FreeBlock* m_FreeBlocks = nullptr;
+        vector<void*> m_Pages;
+        size_t m_UsedBlocks = 0;
+    };
+
+    // Variable-size blocks inside regions of upstream allocator.
+    // Free blocks are kept sorted by address and merged with neighbours, first fit is taken.
+    // It's thread safe.
+    class ENGINE_API FreeListAllocator final : public Allocator {
+
+    public:
+        explicit FreeListAllocator(size_t regionSize, Allocator& upstream = heap_allocator());
+        ~FreeListAllocator() override;
+
+        IMMUTABLE(FreeListAllocator)
+
+    public:
+        void* allocate(size_t size, size_t alignment = default_alignment) override;
+        void deallocate(void* memory, size_t size, size_t alignment = default_alignment) override;
+
+        // bytes of allocated blocks, including headers and padding
+        [[nodiscard]] size_t getUsed();
+        [[nodiscard]] size_t getCapacity();
+
+    private:
+        struct FreeBlock {
+            size_t size;
+            FreeBlock* next;
+        };
+
+        // placed right before returned memory
+        struct BlockHeader {
+            size_t offset; // from block start to returned memory
+            size_t size;
+        };
+
+        void addRegion(size_t size);
+
+    private:
+        std::mutex m_Mutex;
+        Allocator& m_Upstream;
+        size_t m_RegionSize;
+        FreeBlock* m_FreeBlocks = nullptr;
+        vector<std::pair<void*, size_t>> m_Regions;
+        size_t m_Used = 0;
+        size_t m_Capacity = 0;
+    };
+
+    // Linear allocator, allocation is a pointer bump and memory is released all at once by reset().
+    // Blocks are merged on reset into one, that fits all previous allocations.
+    // It's NOT thread safe, see FrameArena for per-thread arenas.
+    class ENGINE_API ArenaAllocator final : public Allocator {
+
+    public:
+        explicit ArenaAllocator(size_t blockSize, Allocator& upstream = heap_allocator());
+        ~ArenaAllocator() override;
+
+        IMMUTABLE(ArenaAllocator)
+
+    public:
+        void* allocate(size_t size, size_t alignment = default_alignment) override;
+        // only last allocation can be rolled back, others are released by reset()
+        void deallocate(void* memory, size_t size, size_t alignment = default_alignment) override;
+        void reset();
+
+        [[nodiscard]] inline size_t getUsed() const {
+            return m_Used;
+        }
+
+        [[nodiscard]] inline size_t getPeak() const {
+            return m_Peak;
+        }
+
+        [[nodiscard]] inline size_t getCapacity() const {
+            return m_Capacity;
+        }
+
+    private:
+        void addBlock(size_t size);
+        void releaseBlocks();
+
+    private:
+        struct Block {
+            u8* data = nullptr;
+            size_t size = 0;
+        };
+
+        Allocator& m_Upstream;
+        size_t m_BlockSize;
+        vector<Block> m_Blocks;
+        u32 m_Block = 0;
+        size_t m_Offset = 0;
+        void* m_Last = nullptr;
+        size_t m_Used = 0;
+        size_t m_Peak = 0;
+        size_t m_Capacity = 0;
+    };
+
+    // STL allocator on top of engine allocator, which must outlive container
+    template<typename T>
+    struct StdAllocator {
+        typedef T value_type;
+
+        Allocator* allocator;
+
+        StdAllocator(Allocator& allocator) noexcept : allocator(&allocator) {}
+
+        template<typename U>
+        StdAllocator(const StdAllocator<U>& other) noexcept : allocator(other.allocator) {}
+
+        inline T* allocate(size_t count) {
+            return static_cast<T*>(allocator->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T* memory, size_t count) noexcept {
+            allocator->deallocate(memory, count * sizeof(T), alignof(T));
+        }
+    };
+
+    template<typename T, typename U>
+    inline bool operator==(const StdAllocator<T>& a, const StdAllocator<U>& b) noexcept {
+        return a.allocator == b.allocator;
+    }
+
+    template<typename T, typename U>
+    inline bool operator!=(const StdAllocator<T>& a, const StdAllocator<U>& b) noexcept {
+        return a.allocator != b.allocator;
+    }
+
+    // destroys object and returns its memory into allocator, which must outlive the pointer
+    template<typename T>
+    struct AllocatorDeleter {
+        Allocator* allocator = nullptr;
+        size_t size = 0;
+        size_t alignment = 0;
+
+        AllocatorDeleter() noexcept = default;
+
+        AllocatorDeleter(Allocator& allocator, size_t size, size_t alignment) noexcept
+        : allocator(&allocator), size(size), alignment(alignment) {}
+
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        AllocatorDeleter(const AllocatorDeleter<U>& other) noexcept
+        : allocator(other.allocator), size(other.size), alignment(other.alignment) {}
+
+        void operator()(T* object) const {
+            // base pointer may not point to the start of derived object
+            void* memory;
+            if constexpr (std::is_polymorphic_v<T>) {
+                memory = dynamic_cast<void*>(object);
+            } else {
+                memory = object;
+            }
+            object->~T();
+            allocator->deallocate(memory, size, alignment);
+        }
+    };
+
+    template<typename T>
+    using AllocatedScope = std::unique_ptr<T, AllocatorDeleter<T>>;
+
+    template<typename A>
+    using enable_if_allocator = std::enable_if_t<std::is_base_of_v<Allocator, std::decay_t<A>>>;
+
+    template<typename T, typename A, typename ... Args, typename = enable_if_allocator<A>>
+    AllocatedScope<T> createScope(A& allocator, Args&& ... args) {
+        void* memory = allocator.allocate(sizeof(T), alignof(T));
+        try {
+            T* object = new (memory) T(std::forward<Args>(args)...);
+            return AllocatedScope<T>(object, AllocatorDeleter<T>(allocator, sizeof(T), alignof(T)));
+        } catch (...) {
+            allocator.deallocate(memory, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+
+    // object and its control block are placed in allocator
+    template<typename T, typename A, typename ... Args, typename = enable_if_allocator<A>>
+    Ref<T> createRef(A& allocator, Args&& ... args) {
+        return std::allocate_shared<T>(StdAllocator<T>(allocator), std::forward<Args>(args)...);
+    }
+
+}
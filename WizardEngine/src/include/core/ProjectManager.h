@@ -24,6 +24,8 @@ namespace engine::core {
         std::string launcher = "";
         WindowProps windowProps = { "Untitled" };
         bool fullscreen = false;
+        // frames between simulation and its render: 0 - serial, 1 - pipelined through RenderSnapshot
+        int renderLatency = 0;
 
         ProjectProps() = default;
 
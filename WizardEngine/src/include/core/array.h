@@ -4,98 +4,282 @@
 
 #pragma once
 
-#include <cstdint>
-#include <functional>
 #include <core/core.h>
+#include <core/primitives.h>
+#include <core/Memory.h>
+
+#include <initializer_list>
+#include <algorithm>
+#include <utility>
+#include <memory>
 
 namespace engine::core {
 
+    // alignment of array values, so they can be loaded with SIMD instructions and copied into GPU buffers
+    constexpr size_t array_alignment = 32;
+
+    // non-owning view of contiguous values, it's valid while owner of values is alive
     template<typename T>
-    struct array {
-        T* values = nullptr;
-        u32 offset = 0;
-        u32 size = 0;
+    class array_view {
 
-        array() = default;
-        array(T* values, u32 offset, u32 size)
-        : values(values), size(size), offset(offset) {}
+    public:
+        array_view() = default;
+        array_view(T* values, u32 size) : m_Values(values), m_Size(size) {}
 
-        void release();
+        // view of mutable values can be used as view of const values
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        array_view(const array_view<U>& other) : m_Values(other.data()), m_Size(other.size()) {}
 
-        void forEach(const std::function<void(const T&)>& function);
-        void forEach(const std::function<void(T&)>& function);
-        void forEach(const std::function<void(T&, u32)>& function);
+    public:
+        [[nodiscard]] inline T* data() const {
+            return m_Values;
+        }
 
-        array<T> copy();
+        [[nodiscard]] inline u32 size() const {
+            return m_Size;
+        }
 
-        template<typename TO>
-        array<TO> toVertexData(const std::function<TO(const T&)>& vertexMapper);
+        [[nodiscard]] inline bool empty() const {
+            return m_Size == 0;
+        }
+
+        inline T& operator[](u32 index) const {
+            return m_Values[index];
+        }
+
+        inline T* begin() const {
+            return m_Values;
+        }
+
+        inline T* end() const {
+            return m_Values + m_Size;
+        }
+
+        [[nodiscard]] inline array_view<T> subview(u32 offset, u32 count) const {
+            return { m_Values + offset, count };
+        }
+
+    private:
+        T* m_Values = nullptr;
+        u32 m_Size = 0;
     };
 
+    // Owning buffer of values, placed in memory of engine allocator.
+    // It's move-only, so deep copies are explicit, see copy() and shared_array for sharing values.
     template<typename T>
-    void array<T>::release() {
-        delete[] values;
-    }
+    class array {
 
-    template<typename T>
-    void array<T>::forEach(const std::function<void(const T&)>& function) {
-        for (u32 i = 0; i < size; i++) {
-            function(values[i]);
+    public:
+        static constexpr size_t alignment = std::max(alignof(T), array_alignment);
+
+        array() = default;
+
+        // values are value-initialized
+        explicit array(u32 size, Allocator& allocator = heap_allocator()) {
+            allocate(size, allocator);
+            std::uninitialized_value_construct_n(m_Values, size);
         }
-    }
 
-    template<typename T>
-    void array<T>::forEach(const std::function<void(T&)>& function) {
-        for (u32 i = 0; i < size; i++) {
-            function(values[i]);
+        array(const T* values, u32 size, Allocator& allocator = heap_allocator()) {
+            allocate(size, allocator);
+            std::uninitialized_copy_n(values, size, m_Values);
         }
-    }
 
-    template<typename T>
-    void array<T>::forEach(const std::function<void(T&, u32)> &function) {
-        for (u32 i = 0; i < size; i++) {
-            function(values[i], i);
+        array(std::initializer_list<T> values, Allocator& allocator = heap_allocator()) {
+            allocate((u32) values.size(), allocator);
+            std::uninitialized_copy(values.begin(), values.end(), m_Values);
         }
-    }
 
-    template<typename T>
-    array<T> array<T>::copy() {
-        auto* copyVertices = new T[size];
-        std::copy(values, values + size, copyVertices);
-
-        return array<T> {
-                copyVertices,
-                offset,
-                size
-        };
-    }
+        array(array&& other) noexcept
+        : m_Values(other.m_Values), m_Size(other.m_Size), m_Allocator(other.m_Allocator) {
+            other.m_Values = nullptr;
+            other.m_Size = 0;
+        }
+
+        array& operator=(array&& other) noexcept {
+            if (this != &other) {
+                clear();
+                std::swap(m_Values, other.m_Values);
+                std::swap(m_Size, other.m_Size);
+                m_Allocator = other.m_Allocator;
+            }
+            return *this;
+        }
+
+        ~array() {
+            clear();
+        }
+
+        IMMUTABLE(array)
+
+    public:
+        // deep copy in the same allocator
+        [[nodiscard]] array<T> copy() const {
+            return m_Allocator ? array<T>(m_Values, m_Size, *m_Allocator) : array<T>();
+        }
+
+        // maps each value into new array in the same allocator, e.g. model vertices into renderer vertices
+        template<typename Mapper, typename TO = std::decay_t<std::invoke_result_t<Mapper, const T&>>>
+        [[nodiscard]] array<TO> map(const Mapper& mapper) const {
+            if (!m_Allocator) return {};
+            array<TO> result(m_Size, *m_Allocator);
+            for (u32 i = 0 ; i < m_Size ; i++) {
+                result[i] = mapper(m_Values[i]);
+            }
+            return result;
+        }
+
+        // destroys values and releases memory
+        void clear() {
+            if (m_Values) {
+                std::destroy_n(m_Values, m_Size);
+                m_Allocator->deallocate(m_Values, m_Size * sizeof(T), alignment);
+                m_Values = nullptr;
+                m_Size = 0;
+            }
+        }
+
+        [[nodiscard]] inline T* data() {
+            return m_Values;
+        }
+
+        [[nodiscard]] inline const T* data() const {
+            return m_Values;
+        }
+
+        [[nodiscard]] inline u32 size() const {
+            return m_Size;
+        }
+
+        [[nodiscard]] inline bool empty() const {
+            return m_Size == 0;
+        }
+
+        inline T& operator[](u32 index) {
+            return m_Values[index];
+        }
+
+        inline const T& operator[](u32 index) const {
+            return m_Values[index];
+        }
+
+        inline T* begin() {
+            return m_Values;
+        }
+
+        inline T* end() {
+            return m_Values + m_Size;
+        }
+
+        inline const T* begin() const {
+            return m_Values;
+        }
+
+        inline const T* end() const {
+            return m_Values + m_Size;
+        }
+
+        [[nodiscard]] inline array_view<T> view() {
+            return { m_Values, m_Size };
+        }
 
+        [[nodiscard]] inline array_view<const T> view() const {
+            return { m_Values, m_Size };
+        }
+
+        [[nodiscard]] inline Allocator* getAllocator() const {
+            return m_Allocator;
+        }
+
+    private:
+        void allocate(u32 size, Allocator& allocator) {
+            m_Allocator = &allocator;
+            if (size == 0) return;
+            m_Values = static_cast<T*>(allocator.allocate(size * sizeof(T), alignment));
+            m_Size = size;
+        }
+
+    private:
+        T* m_Values = nullptr;
+        u32 m_Size = 0;
+        Allocator* m_Allocator = nullptr;
+    };
+
+    // Copy-on-write handle of array values.
+    // Copies share values, until one of them edits them, so components with vertex data are cheap to copy.
+    // Handles may be copied and released on different threads, but single handle can't be edited and copied at once.
     template<typename T>
-    template<typename TO>
-    array<TO> array<T>::toVertexData(const std::function<TO(const T &)>& vertexMapper) {
-        auto* fromVertices = values;
-        auto* toVertices = new TO[size];
-        for (auto i = 0; i < size; i++) {
-            toVertices[i] = vertexMapper(fromVertices[i]);
-        }
-        return array<TO> {
-                toVertices,
-                offset,
-                size
-        };
-    }
+    class shared_array {
+
+    public:
+        // index of first value inside GPU buffer, it's not shared with copies
+        u32 offset = 0;
+
+        shared_array() = default;
+
+        shared_array(array<T>&& values) {
+            if (!values.empty()) {
+                // control block is accounted to the same allocator as values
+                m_Values = createRef<array<T>>(*values.getAllocator(), std::move(values));
+            }
+        }
+
+    public:
+        [[nodiscard]] inline const T* data() const {
+            return m_Values ? m_Values->data() : nullptr;
+        }
+
+        [[nodiscard]] inline u32 size() const {
+            return m_Values ? m_Values->size() : 0;
+        }
+
+        [[nodiscard]] inline bool empty() const {
+            return size() == 0;
+        }
+
+        inline const T& operator[](u32 index) const {
+            return (*m_Values)[index];
+        }
+
+        inline const T* begin() const {
+            return data();
+        }
+
+        inline const T* end() const {
+            return data() + size();
+        }
+
+        [[nodiscard]] inline array_view<const T> view() const {
+            return { data(), size() };
+        }
+
+        [[nodiscard]] inline bool isShared() const {
+            return m_Values.use_count() > 1;
+        }
+
+        // values are copied first, if they are shared with other handles
+        array_view<T> edit() {
+            if (isShared()) {
+                m_Values = createRef<array<T>>(*m_Values->getAllocator(), m_Values->copy());
+            }
+            return m_Values ? m_Values->view() : array_view<T>();
+        }
+
+        template<typename Mapper, typename TO = std::decay_t<std::invoke_result_t<Mapper, const T&>>>
+        [[nodiscard]] array<TO> map(const Mapper& mapper) const {
+            return m_Values ? m_Values->map(mapper) : array<TO>();
+        }
+
+    private:
+        Ref<array<T>> m_Values;
+    };
 
-    template<typename FROM, typename TO>
-    array<TO> toVertexData(const std::vector<FROM>& inVertices) {
-        size_t size = inVertices.size();
-        auto* outVertices = new TO[size];
-        for (auto i = 0; i < size; i++) {
+    template<typename FROM, typename TO, typename Vector>
+    array<TO> toVertexData(const Vector& inVertices, Allocator& allocator = heap_allocator()) {
+        array<TO> outVertices((u32) inVertices.size(), allocator);
+        for (u32 i = 0; i < outVertices.size(); i++) {
             outVertices[i] = { inVertices[i] };
         }
-        return array<TO> {
-                outVertices,
-                0,
-                static_cast<uint32_t>(size)
-        };
+        return outVertices;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,811 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <core/primitives.h>
+#include <core/Memory.h>
+
+#include <functional>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <initializer_list>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace engine::core {
+
+    // Hash of unordered containers.
+    // Strings are hashed by view, so containers with string keys can be searched by const char* or string_view.
+    template<typename T>
+    struct hash : std::hash<T> {};
+
+    struct string_hash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const noexcept {
+            return std::hash<std::string_view>()(value);
+        }
+    };
+
+    template<>
+    struct hash<std::string> : string_hash {};
+
+    template<>
+    struct hash<std::string_view> : string_hash {};
+
+    template<typename T>
+    struct equal_to : std::equal_to<T> {};
+
+    template<>
+    struct equal_to<std::string> : std::equal_to<> {};
+
+    template<>
+    struct equal_to<std::string_view> : std::equal_to<> {};
+
+    namespace flat {
+
+        // control byte of slot: hash bits of full slot, or one of states below
+        typedef s8 ctrl_t;
+        constexpr ctrl_t ctrl_empty = -128; // 0b10000000
+        constexpr ctrl_t ctrl_deleted = -2; // 0b11111110
+
+        constexpr size_t min_capacity = 8;
+
+        inline bool isFull(ctrl_t ctrl) {
+            return ctrl >= 0;
+        }
+
+        // mixes bits of user hash, so identity hashes of ints and pointers are spread over the table
+        inline u64 mix(u64 hash) {
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        inline u32 countTrailingZeros(u64 mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, mask);
+            return index;
+#else
+            return __builtin_ctzll(mask);
+#endif
+        }
+
+        inline u32 countLeadingZeros(u64 mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanReverse64(&index, mask);
+            return 63 - index;
+#else
+            return __builtin_clzll(mask);
+#endif
+        }
+
+        // Control bytes of 8 neighbour slots, compared at once inside one u64.
+        // Each match is a mask with high bit set in bytes of matched slots.
+        struct group {
+            static constexpr size_t width = 8;
+            static constexpr u64 lsbs = 0x0101010101010101ULL;
+            static constexpr u64 msbs = 0x8080808080808080ULL;
+
+            u64 ctrl;
+
+            explicit group(const ctrl_t* pos) {
+                std::memcpy(&ctrl, pos, sizeof(ctrl));
+                if constexpr (endian::native == endian::big) {
+                    ctrl = __builtin_bswap64(ctrl);
+                }
+            }
+
+            // may also match full slot right after matched one, it's filtered by key comparison
+            [[nodiscard]] inline u64 match(u8 h2) const {
+                u64 x = ctrl ^ (lsbs * h2);
+                return (x - lsbs) & ~x & msbs;
+            }
+
+            [[nodiscard]] inline u64 matchEmpty() const {
+                return ctrl & ~(ctrl << 6) & msbs;
+            }
+
+            [[nodiscard]] inline u64 matchEmptyOrDeleted() const {
+                return ctrl & ~(ctrl << 7) & msbs;
+            }
+
+            // slot offset of lowest match
+            static inline u32 lowest(u64 mask) {
+                return countTrailingZeros(mask) >> 3;
+            }
+        };
+
+        template<typename T, typename = void>
+        struct is_transparent : std::false_type {};
+
+        template<typename T>
+        struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+        template<typename T>
+        class slot_iterator {
+
+            template<typename, typename, typename, typename, typename, bool>
+            friend class table;
+
+            template<typename>
+            friend class slot_iterator;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::remove_const_t<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            slot_iterator() = default;
+
+            // iterator can be used as const_iterator
+            template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+            slot_iterator(const slot_iterator<U>& other) : m_Ctrl(other.m_Ctrl), m_Slot(other.m_Slot), m_End(other.m_End) {}
+
+        public:
+            inline reference operator*() const {
+                return *m_Slot;
+            }
+
+            inline pointer operator->() const {
+                return m_Slot;
+            }
+
+            slot_iterator& operator++() {
+                ++m_Ctrl;
+                ++m_Slot;
+                skipEmpty();
+                return *this;
+            }
+
+            slot_iterator operator++(int) {
+                slot_iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            friend inline bool operator==(const slot_iterator& a, const slot_iterator& b) {
+                return a.m_Ctrl == b.m_Ctrl;
+            }
+
+            friend inline bool operator!=(const slot_iterator& a, const slot_iterator& b) {
+                return a.m_Ctrl != b.m_Ctrl;
+            }
+
+        private:
+            slot_iterator(const ctrl_t* ctrl, T* slot, const ctrl_t* end) : m_Ctrl(ctrl), m_Slot(slot), m_End(end) {}
+
+            void skipEmpty() {
+                while (m_Ctrl != m_End && !isFull(*m_Ctrl)) {
+                    ++m_Ctrl;
+                    ++m_Slot;
+                }
+            }
+
+        private:
+            const ctrl_t* m_Ctrl = nullptr;
+            T* m_Slot = nullptr;
+            const ctrl_t* m_End = nullptr;
+        };
+
+        // Open addressing hash table in SwissTable layout.
+        // Values are stored inline in one array, each slot has a control byte with 7 bits of its hash,
+        // so lookup compares 8 control bytes at once and touches values only on probable match.
+        // Erased slots are marked deleted, so erase doesn't move values.
+        // Unlike STL unordered containers, insert may move values, which invalidates references and iterators.
+        template<typename Value, typename Key, typename KeyOf, typename Hash, typename Equal, bool MutableValues>
+        class table {
+
+        public:
+            typedef Key key_type;
+            typedef Value value_type;
+            typedef size_t size_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Hash hasher;
+            typedef Equal key_equal;
+            typedef value_type& reference;
+            typedef const value_type& const_reference;
+            typedef slot_iterator<std::conditional_t<MutableValues, Value, const Value>> iterator;
+            typedef slot_iterator<const Value> const_iterator;
+
+        protected:
+            static constexpr size_t npos = ~size_t(0);
+            static constexpr size_t slot_alignment = std::max(alignof(Value), alignof(u64));
+
+            // keys of other types can be searched without conversion, when hash and equal are transparent
+            template<typename K>
+            using enable_if_lookup = std::enable_if_t<
+                    is_transparent<Hash>::value && is_transparent<Equal>::value && !std::is_same_v<K, Key>
+            >;
+
+        public:
+            table() = default;
+
+            explicit table(size_t capacity) {
+                reserve(capacity);
+            }
+
+            table(std::initializer_list<Value> values) {
+                insert(values.begin(), values.end());
+            }
+
+            template<typename InputIt>
+            table(InputIt first, InputIt last) {
+                insert(first, last);
+            }
+
+            table(const table& other) : m_Hash(other.m_Hash), m_Equal(other.m_Equal) {
+                reserve(other.m_Size);
+                for (const Value& value : other) {
+                    size_t hash = hashOf(KeyOf()(value));
+                    size_t index = prepareInsert(hash);
+                    constructAt(index, value);
+                }
+            }
+
+            table(table&& other) noexcept
+            : m_Ctrl(other.m_Ctrl), m_Slots(other.m_Slots),
+            m_Capacity(other.m_Capacity), m_Size(other.m_Size), m_GrowthLeft(other.m_GrowthLeft),
+            m_Hash(std::move(other.m_Hash)), m_Equal(std::move(other.m_Equal)) {
+                other.m_Ctrl = nullptr;
+                other.m_Slots = nullptr;
+                other.m_Capacity = 0;
+                other.m_Size = 0;
+                other.m_GrowthLeft = 0;
+            }
+
+            table& operator=(const table& other) {
+                if (this != &other) {
+                    table copy(other);
+                    swap(copy);
+                }
+                return *this;
+            }
+
+            table& operator=(table&& other) noexcept {
+                if (this != &other) {
+                    table moved(std::move(other));
+                    swap(moved);
+                }
+                return *this;
+            }
+
+            table& operator=(std::initializer_list<Value> values) {
+                clear();
+                insert(values.begin(), values.end());
+                return *this;
+            }
+
+            ~table() {
+                destroyValues();
+                releaseSlots(m_Slots, m_Capacity);
+            }
+
+        public:
+            iterator begin() {
+                iterator it(m_Ctrl, m_Slots, m_Ctrl + m_Capacity);
+                it.skipEmpty();
+                return it;
+            }
+
+            const_iterator begin() const {
+                const_iterator it(m_Ctrl, m_Slots, m_Ctrl + m_Capacity);
+                it.skipEmpty();
+                return it;
+            }
+
+            const_iterator cbegin() const {
+                return begin();
+            }
+
+            iterator end() {
+                return iteratorAt(m_Capacity);
+            }
+
+            const_iterator end() const {
+                return iteratorAt(m_Capacity);
+            }
+
+            const_iterator cend() const {
+                return end();
+            }
+
+            [[nodiscard]] inline bool empty() const {
+                return m_Size == 0;
+            }
+
+            [[nodiscard]] inline size_t size() const {
+                return m_Size;
+            }
+
+            [[nodiscard]] inline size_t capacity() const {
+                return m_Capacity;
+            }
+
+            [[nodiscard]] inline float load_factor() const {
+                return m_Capacity == 0 ? 0 : (float) m_Size / (float) m_Capacity;
+            }
+
+            // values are destroyed, but memory is kept for next inserts
+            void clear() {
+                if (m_Capacity == 0) return;
+                destroyValues();
+                std::memset(m_Ctrl, ctrl_empty, m_Capacity + group::width);
+                m_Size = 0;
+                m_GrowthLeft = growthOf(m_Capacity);
+            }
+
+            // fits count values without rehash
+            void reserve(size_t count) {
+                if (count > m_Size + m_GrowthLeft) {
+                    resize(std::max(capacityOf(count), m_Capacity));
+                }
+            }
+
+            void swap(table& other) noexcept {
+                std::swap(m_Ctrl, other.m_Ctrl);
+                std::swap(m_Slots, other.m_Slots);
+                std::swap(m_Capacity, other.m_Capacity);
+                std::swap(m_Size, other.m_Size);
+                std::swap(m_GrowthLeft, other.m_GrowthLeft);
+                std::swap(m_Hash, other.m_Hash);
+                std::swap(m_Equal, other.m_Equal);
+            }
+
+            std::pair<iterator, bool> insert(const Value& value) {
+                return emplaceValue(value);
+            }
+
+            std::pair<iterator, bool> insert(Value&& value) {
+                return emplaceValue(std::move(value));
+            }
+
+            template<typename P, typename = std::enable_if_t<std::is_constructible_v<Value, P&&>>>
+            std::pair<iterator, bool> insert(P&& value) {
+                return emplace(std::forward<P>(value));
+            }
+
+            template<typename InputIt>
+            void insert(InputIt first, InputIt last) {
+                for (; first != last; ++first) {
+                    emplace(*first);
+                }
+            }
+
+            void insert(std::initializer_list<Value> values) {
+                insert(values.begin(), values.end());
+            }
+
+            // value is constructed first to get its key, use try_emplace() of map to avoid it
+            template<typename... Args>
+            std::pair<iterator, bool> emplace(Args&&... args) {
+                return emplaceValue(Value(std::forward<Args>(args)...));
+            }
+
+            iterator find(const Key& key) {
+                return iteratorAt(findIndex(key, hashOf(key)));
+            }
+
+            const_iterator find(const Key& key) const {
+                return iteratorAt(findIndex(key, hashOf(key)));
+            }
+
+            template<typename K, typename = enable_if_lookup<K>>
+            iterator find(const K& key) {
+                return iteratorAt(findIndex(key, hashOf(key)));
+            }
+
+            template<typename K, typename = enable_if_lookup<K>>
+            const_iterator find(const K& key) const {
+                return iteratorAt(findIndex(key, hashOf(key)));
+            }
+
+            [[nodiscard]] bool contains(const Key& key) const {
+                return findIndex(key, hashOf(key)) != npos;
+            }
+
+            template<typename K, typename = enable_if_lookup<K>>
+            [[nodiscard]] bool contains(const K& key) const {
+                return findIndex(key, hashOf(key)) != npos;
+            }
+
+            [[nodiscard]] size_t count(const Key& key) const {
+                return contains(key) ? 1 : 0;
+            }
+
+            template<typename K, typename = enable_if_lookup<K>>
+            [[nodiscard]] size_t count(const K& key) const {
+                return contains(key) ? 1 : 0;
+            }
+
+            // returns iterator to the next value, other iterators stay valid
+            iterator erase(const_iterator pos) {
+                size_t index = pos.m_Ctrl - m_Ctrl;
+                eraseAt(index);
+                iterator it = iteratorAt(index);
+                ++it;
+                return it;
+            }
+
+            // iterator of set is const_iterator
+            template<bool MUTABLE = MutableValues, typename = std::enable_if_t<MUTABLE>>
+            iterator erase(iterator pos) {
+                return erase(const_iterator(pos));
+            }
+
+            size_t erase(const Key& key) {
+                return eraseKey(key);
+            }
+
+            template<typename K, typename = enable_if_lookup<K>>
+            size_t erase(const K& key) {
+                return eraseKey(key);
+            }
+
+            [[nodiscard]] inline hasher hash_function() const {
+                return m_Hash;
+            }
+
+            [[nodiscard]] inline key_equal key_eq() const {
+                return m_Equal;
+            }
+
+        protected:
+            template<typename K>
+            inline size_t hashOf(const K& key) const {
+                return (size_t) mix(m_Hash(key));
+            }
+
+            template<typename K>
+            size_t findIndex(const K& key, size_t hash) const {
+                if (m_Capacity == 0) return npos;
+
+                size_t mask = m_Capacity - 1;
+                size_t pos = (hash >> 7) & mask;
+                size_t step = 0;
+                u8 h2 = hash & 0x7F;
+                while (true) {
+                    group g(m_Ctrl + pos);
+                    for (u64 match = g.match(h2) ; match ; match &= match - 1) {
+                        size_t index = (pos + group::lowest(match)) & mask;
+                        if (m_Equal(KeyOf()(m_Slots[index]), key)) {
+                            return index;
+                        }
+                    }
+                    // table always has empty slots, so probe ends on first group with one
+                    if (g.matchEmpty()) return npos;
+                    // triangular probing visits each group once
+                    step += group::width;
+                    pos = (pos + step) & mask;
+                }
+            }
+
+            // finds free slot for a new value with the hash and takes it, table may rehash
+            size_t prepareInsert(size_t hash) {
+                if (m_Capacity == 0) {
+                    resize(min_capacity);
+                }
+                size_t index = findFree(hash);
+                // deleted slot can be reused without growth
+                if (m_GrowthLeft == 0 && m_Ctrl[index] != ctrl_deleted) {
+                    rehashForGrowth();
+                    index = findFree(hash);
+                }
+                m_GrowthLeft -= m_Ctrl[index] == ctrl_empty;
+                setCtrl(index, hash & 0x7F);
+                m_Size++;
+                return index;
+            }
+
+            template<typename... Args>
+            void constructAt(size_t index, Args&&... args) {
+                try {
+                    new (m_Slots + index) Value(std::forward<Args>(args)...);
+                } catch (...) {
+                    setCtrl(index, ctrl_deleted);
+                    m_Size--;
+                    throw;
+                }
+            }
+
+            inline iterator iteratorAt(size_t index) {
+                if (index == npos) index = m_Capacity;
+                return iterator(m_Ctrl + index, m_Slots + index, m_Ctrl + m_Capacity);
+            }
+
+            inline const_iterator iteratorAt(size_t index) const {
+                if (index == npos) index = m_Capacity;
+                return const_iterator(m_Ctrl + index, m_Slots + index, m_Ctrl + m_Capacity);
+            }
+
+            template<typename K>
+            std::pair<iterator, bool> findOrInsert(const K& key, size_t hash, size_t& index) {
+                index = findIndex(key, hash);
+                if (index != npos) {
+                    return { iteratorAt(index), false };
+                }
+                index = prepareInsert(hash);
+                return { iteratorAt(index), true };
+            }
+
+        private:
+            template<typename V>
+            std::pair<iterator, bool> emplaceValue(V&& value) {
+                const auto& key = KeyOf()(value);
+                size_t hash = hashOf(key);
+                size_t index = findIndex(key, hash);
+                if (index != npos) {
+                    return { iteratorAt(index), false };
+                }
+                index = prepareInsert(hash);
+                constructAt(index, std::forward<V>(value));
+                return { iteratorAt(index), true };
+            }
+
+            template<typename K>
+            size_t eraseKey(const K& key) {
+                size_t index = findIndex(key, hashOf(key));
+                if (index == npos) return 0;
+                eraseAt(index);
+                return 1;
+            }
+
+            void eraseAt(size_t index) {
+                m_Slots[index].~Value();
+                m_Size--;
+                // slot can be marked empty, if no probe has ever passed it,
+                // it's so when run of full slots around it is shorter than group
+                size_t mask = m_Capacity - 1;
+                u64 emptyBefore = group(m_Ctrl + ((index - group::width) & mask)).matchEmpty();
+                u64 emptyAfter = group(m_Ctrl + index).matchEmpty();
+                bool wasNeverFull = emptyBefore && emptyAfter &&
+                        (group::lowest(emptyAfter) + (countLeadingZeros(emptyBefore) >> 3)) < group::width;
+                if (wasNeverFull) {
+                    setCtrl(index, ctrl_empty);
+                    m_GrowthLeft++;
+                } else {
+                    setCtrl(index, ctrl_deleted);
+                }
+            }
+
+            size_t findFree(size_t hash) const {
+                size_t mask = m_Capacity - 1;
+                size_t pos = (hash >> 7) & mask;
+                size_t step = 0;
+                while (true) {
+                    u64 free = group(m_Ctrl + pos).matchEmptyOrDeleted();
+                    if (free) {
+                        return (pos + group::lowest(free)) & mask;
+                    }
+                    step += group::width;
+                    pos = (pos + step) & mask;
+                }
+            }
+
+            // first group_width control bytes are cloned after the last one, so group can be read at any slot
+            inline void setCtrl(size_t index, ctrl_t ctrl) {
+                m_Ctrl[index] = ctrl;
+                if (index < group::width) {
+                    m_Ctrl[m_Capacity + index] = ctrl;
+                }
+            }
+
+            // tables up to 7/8 full, so probes stay short and always find an empty slot
+            static inline size_t growthOf(size_t capacity) {
+                return capacity - capacity / 8;
+            }
+
+            static size_t capacityOf(size_t count) {
+                size_t capacity = min_capacity;
+                while (growthOf(capacity) < count) {
+                    capacity *= 2;
+                }
+                return capacity;
+            }
+
+            void rehashForGrowth() {
+                // many deleted slots are cleaned up in place, instead of growing the table
+                if (m_Size <= growthOf(m_Capacity) / 2) {
+                    resize(m_Capacity);
+                } else {
+                    resize(m_Capacity * 2);
+                }
+            }
+
+            void resize(size_t capacity) {
+                ctrl_t* oldCtrl = m_Ctrl;
+                Value* oldSlots = m_Slots;
+                size_t oldCapacity = m_Capacity;
+
+                allocateSlots(capacity);
+                m_GrowthLeft = growthOf(capacity) - m_Size;
+
+                for (size_t i = 0 ; i < oldCapacity ; i++) {
+                    if (isFull(oldCtrl[i])) {
+                        Value& value = oldSlots[i];
+                        size_t hash = hashOf(KeyOf()(value));
+                        size_t index = findFree(hash);
+                        setCtrl(index, hash & 0x7F);
+                        new (m_Slots + index) Value(std::move(value));
+                        value.~Value();
+                    }
+                }
+
+                releaseSlots(oldSlots, oldCapacity);
+            }
+
+            // slots and control bytes are placed in one block
+            static inline size_t blockSize(size_t capacity) {
+                return capacity * sizeof(Value) + capacity + group::width;
+            }
+
+            void allocateSlots(size_t capacity) {
+                void* block = heap_allocator().allocate(blockSize(capacity), slot_alignment);
+                m_Slots = static_cast<Value*>(block);
+                m_Ctrl = reinterpret_cast<ctrl_t*>(m_Slots + capacity);
+                m_Capacity = capacity;
+                std::memset(m_Ctrl, ctrl_empty, capacity + group::width);
+            }
+
+            static void releaseSlots(Value* slots, size_t capacity) {
+                if (capacity == 0) return;
+                heap_allocator().deallocate(slots, blockSize(capacity), slot_alignment);
+            }
+
+            void destroyValues() {
+                if constexpr (!std::is_trivially_destructible_v<Value>) {
+                    for (size_t i = 0 ; i < m_Capacity ; i++) {
+                        if (isFull(m_Ctrl[i])) {
+                            m_Slots[i].~Value();
+                        }
+                    }
+                }
+            }
+
+        private:
+            ctrl_t* m_Ctrl = nullptr;
+            Value* m_Slots = nullptr;
+            size_t m_Capacity = 0;
+            size_t m_Size = 0;
+            size_t m_GrowthLeft = 0;
+            Hash m_Hash;
+            Equal m_Equal;
+        };
+
+        template<typename K, typename V>
+        struct map_key {
+            inline const K& operator()(const std::pair<K, V>& value) const {
+                return value.first;
+            }
+        };
+
+        template<typename K>
+        struct set_key {
+            inline const K& operator()(const K& value) const {
+                return value;
+            }
+        };
+    }
+
+    // Flat hash map, values are stored as std::pair<K, V>, so key must not be changed through iterator.
+    template<typename K, typename V, typename Hash = core::hash<K>, typename Equal = core::equal_to<K>>
+    class flat_map : public flat::table<std::pair<K, V>, K, flat::map_key<K, V>, Hash, Equal, true> {
+
+        typedef flat::table<std::pair<K, V>, K, flat::map_key<K, V>, Hash, Equal, true> table;
+
+    public:
+        typedef V mapped_type;
+        typedef typename table::iterator iterator;
+        typedef typename table::const_iterator const_iterator;
+
+        using table::table;
+        using table::operator=;
+
+    public:
+        // value is constructed only, if key is not found
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+            return tryEmplace(key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+            return tryEmplace(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if (!result.second) {
+                result.first->second = std::forward<M>(value);
+            }
+            return result;
+        }
+
+        V& operator[](const K& key) {
+            return try_emplace(key).first->second;
+        }
+
+        V& operator[](K&& key) {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        V& at(const K& key) {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_map::at: key not found");
+            }
+            return it->second;
+        }
+
+        const V& at(const K& key) const {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_map::at: key not found");
+            }
+            return it->second;
+        }
+
+        template<typename Q, typename = typename table::template enable_if_lookup<Q>>
+        V& at(const Q& key) {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_map::at: key not found");
+            }
+            return it->second;
+        }
+
+        template<typename Q, typename = typename table::template enable_if_lookup<Q>>
+        const V& at(const Q& key) const {
+            auto it = this->find(key);
+            if (it == this->end()) {
+                throw std::out_of_range("flat_map::at: key not found");
+            }
+            return it->second;
+        }
+
+    private:
+        template<typename KK, typename... Args>
+        std::pair<iterator, bool> tryEmplace(KK&& key, Args&&... args) {
+            size_t index;
+            auto result = this->findOrInsert(key, this->hashOf(key), index);
+            if (result.second) {
+                this->constructAt(
+                        index,
+                        std::piecewise_construct,
+                        std::forward_as_tuple(std::forward<KK>(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...)
+                );
+            }
+            return result;
+        }
+    };
+
+    // Flat hash set, values are immutable through iterators.
+    template<typename K, typename Hash = core::hash<K>, typename Equal = core::equal_to<K>>
+    class flat_set : public flat::table<K, K, flat::set_key<K>, Hash, Equal, false> {
+
+        typedef flat::table<K, K, flat::set_key<K>, Hash, Equal, false> table;
+
+    public:
+        using table::table;
+        using table::operator=;
+    };
+
+}
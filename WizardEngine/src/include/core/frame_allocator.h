@@ -0,0 +1,97 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <core/core.h>
+#include <core/primitives.h>
+#include <core/immutable.h>
+#include <core/Memory.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace engine::core {
+
+    constexpr size_t frame_arena_block_size = kb_256;
+
+    // Linear allocator for transient per-frame data, one per thread.
+    // Allocation is a pointer bump, memory is released all at once, when frame ends.
+    // Arena is reset lazily by its first allocation after nextFrame(),
+    // so frame memory must not be used after the frame, in which it was allocated.
+    // Threads, that don't follow frames, e.g. timer or network threads, should not use it,
+    // as their arena would grow until next frame.
+    class ENGINE_API FrameArena final {
+
+    public:
+        FrameArena() = default;
+        ~FrameArena() = default;
+
+        IMMUTABLE(FrameArena)
+
+    public:
+        // arena of calling thread
+        static FrameArena& get();
+        // invalidates memory of all arenas, called once per frame from main thread, after frame sync point
+        static void nextFrame();
+        static u64 getFrame();
+
+    public:
+        void* allocate(size_t size, size_t alignment = default_alignment);
+        // memory is freed with the whole frame, only last allocation can be rolled back
+        void deallocate(void* memory, size_t size);
+
+        // bytes allocated in current frame
+        [[nodiscard]] inline size_t getUsed() const {
+            return m_Arena.getUsed();
+        }
+
+        // most bytes allocated in one frame
+        [[nodiscard]] inline size_t getPeak() const {
+            return m_Arena.getPeak();
+        }
+
+        [[nodiscard]] inline size_t getCapacity() const {
+            return m_Arena.getCapacity();
+        }
+
+    private:
+        ArenaAllocator m_Arena { frame_arena_block_size };
+        u64 m_Frame = 0;
+    };
+
+    // STL allocator on top of calling thread's FrameArena, e.g. for temporary containers in render loop
+    // it's stateless, so containers may be swapped or moved, but only inside one frame
+    template<typename T>
+    struct FrameAllocator {
+        typedef T value_type;
+
+        FrameAllocator() noexcept = default;
+
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+        inline T* allocate(size_t count) {
+            return static_cast<T*>(FrameArena::get().allocate(count * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T* memory, size_t count) noexcept {
+            FrameArena::get().deallocate(memory, count * sizeof(T));
+        }
+    };
+
+    template<typename T, typename U>
+    inline bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) noexcept {
+        return true;
+    }
+
+    template<typename T, typename U>
+    inline bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) noexcept {
+        return false;
+    }
+
+    template<typename T>
+    using frame_vector = std::vector<T, FrameAllocator<T>>;
+
+}
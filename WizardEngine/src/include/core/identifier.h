@@ -54,6 +54,25 @@ namespace engine::core {
         return index(id) | (generation << internal::index_bit);
     }
 
+    // FNV-1a hash of string, evaluated at compile time for string literals
+    constexpr u64 hash_string(const char* str) {
+        u64 hash = 0xcbf2'9ce4'8422'2325;
+        while (*str) {
+            hash = (hash ^ (u8) *str++) * 0x0000'0100'0000'01b3;
+        }
+        return hash;
+    }
+
+    // compile-time identifier of type, stable between modules, because it's a hash of function signature with type name
+    template<typename T>
+    constexpr u64 type_hash() {
+#if defined(_MSC_VER)
+        return hash_string(__FUNCSIG__);
+#else
+        return hash_string(__PRETTY_FUNCTION__);
+#endif
+    }
+
 #ifdef DEBUG
 namespace internal {
 
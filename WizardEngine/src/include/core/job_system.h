@@ -4,13 +4,21 @@
 #include <core/primitives.h>
 #include <core/Assert.h>
 #include <core/Memory.h>
+#include <core/vector.h>
+#include <core/immutable.h>
+#include <core/timer_wheel.h>
 #include <thread/Thread.h>
 
 #include <functional>
 #include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+#include <new>
 #include <condition_variable>
 #include <atomic>
 #include <mutex>
+#include <chrono>
 
 namespace engine::core {
 
@@ -54,43 +62,174 @@ namespace engine::core {
         return result.get();
     }
 
+    constexpr size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // bounded lock-free multi-producer/multi-consumer queue
+    // every cell has sequence number, which tells producers and consumers whose turn it is to use the cell
     template<typename T, size_t capacity>
     class RingBuffer final {
 
     public:
+        RingBuffer();
+
+    public:
+        // returns false if queue is full
         bool pushBack(const T& item);
+        // returns false if queue is empty
         bool popFront(T& item);
+        [[nodiscard]] bool isEmpty() const;
 
     private:
-        T m_Data[capacity];
-        size_t m_Tail = 0;
-        size_t m_Head = 0;
-        std::mutex m_Lock;
+        static constexpr size_t m_Capacity = round_up_pow2(capacity);
+        static constexpr size_t m_Mask = m_Capacity - 1;
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        Cell m_Data[m_Capacity];
+        // producers and consumers are kept on separate cache lines
+        alignas(64) std::atomic<size_t> m_Head { 0 };
+        alignas(64) std::atomic<size_t> m_Tail { 0 };
     };
 
+    template<typename T, size_t capacity>
+    RingBuffer<T, capacity>::RingBuffer() {
+        for (size_t i = 0 ; i < m_Capacity ; i++) {
+            m_Data[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
     template<typename T, size_t capacity>
     bool RingBuffer<T, capacity>::pushBack(const T &item) {
-        bool pushed = false;
-        std::lock_guard<std::mutex> lock(m_Lock);
-        size_t next = (m_Head + 1) % capacity;
-        if (next != m_Tail) {
-            m_Data[m_Head] = item;
-            m_Head = next;
-            pushed = true;
+        size_t position = m_Head.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_Data[position & m_Mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = (intptr_t) sequence - (intptr_t) position;
+            if (diff == 0) {
+                if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_Head.load(std::memory_order_relaxed);
+            }
         }
-        return pushed;
+        cell->data = item;
+        // seq_cst, so sleeping workers check is ordered after push, see JobScheduler::wake()
+        cell->sequence.store(position + 1, std::memory_order_seq_cst);
+        return true;
     }
 
     template<typename T, size_t capacity>
     bool RingBuffer<T, capacity>::popFront(T &item) {
-        bool popped = false;
-        std::lock_guard<std::mutex> lock(m_Lock);
-        if (m_Tail != m_Head) {
-            item = m_Data[m_Tail];
-            m_Tail = (m_Tail + 1) % capacity;
-            popped = true;
+        size_t position = m_Tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_Data[position & m_Mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = (intptr_t) sequence - (intptr_t) (position + 1);
+            if (diff == 0) {
+                if (m_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_Tail.load(std::memory_order_relaxed);
+            }
         }
-        return popped;
+        item = cell->data;
+        cell->sequence.store(position + m_Mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T, size_t capacity>
+    bool RingBuffer<T, capacity>::isEmpty() const {
+        size_t position = m_Tail.load(std::memory_order_seq_cst);
+        return m_Data[position & m_Mask].sequence.load(std::memory_order_seq_cst) != position + 1;
+    }
+
+    // Chase-Lev work-stealing deque of fixed capacity
+    // owner thread pushes and pops items at the bottom, other threads steal them from the top
+    template<typename T, size_t capacity>
+    class WorkStealingDeque final {
+
+    public:
+        // owner only, returns false if deque is full
+        bool push(T item);
+        // owner only, takes the newest item
+        bool pop(T& item);
+        // any thread, takes the oldest item, may fail when other thread takes it at the same time
+        bool steal(T& item);
+        [[nodiscard]] bool isEmpty() const;
+
+    private:
+        static constexpr size_t m_Capacity = round_up_pow2(capacity);
+        static constexpr size_t m_Mask = m_Capacity - 1;
+
+        std::atomic<T> m_Data[m_Capacity];
+        alignas(64) std::atomic<s64> m_Top { 0 };
+        alignas(64) std::atomic<s64> m_Bottom { 0 };
+    };
+
+    template<typename T, size_t capacity>
+    bool WorkStealingDeque<T, capacity>::push(T item) {
+        s64 bottom = m_Bottom.load(std::memory_order_relaxed);
+        s64 top = m_Top.load(std::memory_order_acquire);
+        if (bottom - top >= (s64) m_Capacity) {
+            return false;
+        }
+        m_Data[bottom & m_Mask].store(item, std::memory_order_relaxed);
+        m_Bottom.store(bottom + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    template<typename T, size_t capacity>
+    bool WorkStealingDeque<T, capacity>::pop(T& item) {
+        s64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+        m_Bottom.store(bottom, std::memory_order_seq_cst);
+        s64 top = m_Top.load(std::memory_order_seq_cst);
+        if (top > bottom) {
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = m_Data[bottom & m_Mask].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // last item, race with thieves for it
+            bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    template<typename T, size_t capacity>
+    bool WorkStealingDeque<T, capacity>::steal(T& item) {
+        s64 top = m_Top.load(std::memory_order_seq_cst);
+        s64 bottom = m_Bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom) {
+            return false;
+        }
+
+        item = m_Data[top & m_Mask].load(std::memory_order_relaxed);
+        return m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    template<typename T, size_t capacity>
+    bool WorkStealingDeque<T, capacity>::isEmpty() const {
+        return m_Top.load(std::memory_order_seq_cst) >= m_Bottom.load(std::memory_order_seq_cst);
     }
 
     struct ENGINE_API JobArgs {
@@ -98,38 +237,344 @@ namespace engine::core {
         u32 groupIndex = 0;
     };
 
+    // capacity of job deque of each worker
+    constexpr size_t worker_jobs_capacity = 1024;
+    // size of closure, which is stored inside of job without heap allocation
+    constexpr size_t job_inline_size = 64;
+    // count of jobs allocated at once by scheduler, jobs are recycled and never returned to global allocator
+    constexpr u32 job_slab_size = 256;
+
+    // type-erased callable, closures up to job_inline_size bytes are stored inline, larger ones on heap
+    class ENGINE_API Job final {
+
+    public:
+        Job() = default;
+        ~Job() {
+            reset();
+        }
+
+        template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Job>>>
+        Job(Function&& function) {
+            set(std::forward<Function>(function));
+        }
+
+        Job(Job&& other) noexcept {
+            moveFrom(other);
+        }
+
+        Job& operator=(Job&& other) noexcept {
+            if (this != &other) {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        Job(const Job&) = delete;
+        Job& operator=(const Job&) = delete;
+
+    public:
+        template<typename Function>
+        void set(Function&& function);
+
+        inline void operator()() {
+            m_Invoke(m_Storage);
+        }
+
+        explicit operator bool() const {
+            return m_Invoke != nullptr;
+        }
+
+        inline void reset() {
+            if (m_Manage) {
+                m_Manage(nullptr, m_Storage);
+                m_Invoke = nullptr;
+                m_Manage = nullptr;
+            }
+        }
+
+        template<typename Function>
+        static constexpr bool isInline() {
+            using Closure = std::decay_t<Function>;
+            return sizeof(Closure) <= job_inline_size
+            && alignof(Closure) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Closure>;
+        }
+
+    private:
+        inline void moveFrom(Job& other) {
+            if (other.m_Manage) {
+                other.m_Manage(m_Storage, other.m_Storage);
+                m_Invoke = other.m_Invoke;
+                m_Manage = other.m_Manage;
+                other.m_Invoke = nullptr;
+                other.m_Manage = nullptr;
+            }
+        }
+
+    private:
+        alignas(std::max_align_t) u8 m_Storage[job_inline_size];
+        void (*m_Invoke)(void* storage) = nullptr;
+        // moves closure from src into dst and destroys src, when dst is nullptr closure is only destroyed
+        void (*m_Manage)(void* dst, void* src) = nullptr;
+    };
+
+    template<typename Function>
+    void Job::set(Function&& function) {
+        using Closure = std::decay_t<Function>;
+        reset();
+        if constexpr (isInline<Function>()) {
+            new(m_Storage) Closure(std::forward<Function>(function));
+            m_Invoke = [](void* storage) {
+                (*(Closure*) storage)();
+            };
+            m_Manage = [](void* dst, void* src) {
+                if (dst) {
+                    new(dst) Closure(std::move(*(Closure*) src));
+                }
+                ((Closure*) src)->~Closure();
+            };
+        } else {
+            // storage keeps only pointer to oversized closure
+            *(Closure**) m_Storage = new Closure(std::forward<Function>(function));
+            m_Invoke = [](void* storage) {
+                (**(Closure**) storage)();
+            };
+            m_Manage = [](void* dst, void* src) {
+                if (dst) {
+                    *(Closure**) dst = *(Closure**) src;
+                } else {
+                    delete *(Closure**) src;
+                }
+            };
+        }
+    }
+
+    // completion state shared by job and its handles
+    // continuations are called by the thread, which completes the last pending job
+    class ENGINE_API JobCounter final {
+        IMMUTABLE(JobCounter)
+    public:
+        explicit JobCounter(u32 pending) : m_Pending(pending) {}
+
+    public:
+        [[nodiscard]] inline bool isDone() const {
+            return m_Pending.load() == 0;
+        }
+
+        // continuation is called right away, if counter is already done
+        void addContinuation(const std::function<void()>& continuation);
+        void complete();
+
+    private:
+        std::atomic<u32> m_Pending;
+        std::mutex m_Mutex;
+        bool m_Finished = false; // guarded by m_Mutex
+        vector<std::function<void()>> m_Continuations;
+    };
+
+    inline void JobCounter::addContinuation(const std::function<void()>& continuation) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Finished) {
+                m_Continuations.emplace_back(continuation);
+                return;
+            }
+        }
+        continuation();
+    }
+
+    inline void JobCounter::complete() {
+        if (m_Pending.fetch_sub(1) != 1) return;
+
+        vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Finished = true;
+            continuations.swap(m_Continuations);
+        }
+        for (const auto& continuation : continuations) {
+            continuation();
+        }
+    }
+
+    // lightweight reference to submitted job, default handle is always done
+    class ENGINE_API JobHandle final {
+
+    public:
+        JobHandle() = default;
+        explicit JobHandle(const Ref<JobCounter>& counter) : m_Counter(counter) {}
+
+    public:
+        [[nodiscard]] inline bool isDone() const {
+            return !m_Counter || m_Counter->isDone();
+        }
+
+        // function is called, when job is done, by the thread that completed it
+        inline void then(const std::function<void()>& function) const {
+            if (m_Counter) {
+                m_Counter->addContinuation(function);
+            } else {
+                function();
+            }
+        }
+
+    private:
+        Ref<JobCounter> m_Counter;
+    };
+
+    // returns handle, which is done when all of handles are done
+    inline JobHandle dependsOn(const vector<JobHandle>& handles) {
+        Ref<JobCounter> counter = createRef<JobCounter>((u32) handles.size() + 1);
+        for (const auto& handle : handles) {
+            handle.then([counter]() {
+                counter->complete();
+            });
+        }
+        counter->complete();
+        return JobHandle(counter);
+    }
+
+    template<typename... Handles>
+    inline JobHandle dependsOn(const JobHandle& handle, const Handles&... handles) {
+        return dependsOn(vector<JobHandle> { handle, handles... });
+    }
+
+    // jobs submitted by workers go into their own deques, jobs of other threads go into shared injection queue
+    // idle workers steal jobs from random workers and park, when there is nothing to steal
     template<size_t jobs_capacity>
     class JobScheduler final {
-
+        IMMUTABLE(JobScheduler)
     public:
-        JobScheduler(u32 workerSize, const ThreadFormat& threadFormat);
+        // callersHelp - threads outside of scheduler may run its jobs, while they wait in waitFor() or parallelFor()
+        // it should be disabled for schedulers, which jobs must run on their own threads, e.g. render thread
+        JobScheduler(u32 workerSize, const ThreadFormat& threadFormat, bool callersHelp = true);
+        ~JobScheduler();
 
     public:
         // executes single job in a single worker thread
-        void execute(const std::function<void()>& job);
+        template<typename Function>
+        JobHandle execute(Function&& job);
+        // executes job, when dependency is done, see dependsOn() to wait for multiple jobs
+        template<typename Function>
+        JobHandle execute(const JobHandle& dependency, Function&& job);
         // executes multiple jobs with multiple amount of workers per job
         // jobSize - count of inner jobs inside single job
         // jobsPerThread - count of jobs for each worker thread
         void execute(u32 jobsPerThread, u32 jobSize, const std::function<void(JobArgs)>& job);
+        // executes job for each index in [0, count) split into groups of groupSize and returns when all of them are done
+        // calling thread executes groups too and waits only for its own groups, so it's safe to call from worker thread
+        void parallelFor(u32 count, u32 groupSize, const std::function<void(JobArgs)>& job);
+        // executes job once, after delay
+        // timer thread of scheduler starts with first timer and only moves fired jobs into job queues
+        template<typename Function>
+        TimerHandle executeAfter(std::chrono::milliseconds delay, Function&& job);
+        // executes job every period, until timer is cancelled, next job may start before previous one ends
+        template<typename Function>
+        TimerHandle executeEvery(std::chrono::milliseconds period, Function&& job);
+        // returns false, if job of timer has already been fired or timer was cancelled
+        bool cancelTimer(const TimerHandle& handle);
 
         inline bool isBusy();
 
+        [[nodiscard]] inline u32 getWorkerSize() const {
+            return m_WorkerSize;
+        }
+
+        // blocks calling thread until all executed jobs are done, jobs of pending timers are not waited
         void wait();
+        // returns when job of handle is done, meanwhile calling thread runs other jobs instead of spinning
+        void waitFor(const JobHandle& handle);
 
     private:
-        // wakes only one worker
-        // allows calling thread to be rescheduled by OS
-        inline void poll();
-        void setupThread(int workerId, const ThreadFormat& threadFormat);
+        struct JobNode {
+            Job job;
+            JobNode* next = nullptr;
+        };
+
+        struct Worker {
+            WorkStealingDeque<JobNode*, worker_jobs_capacity> jobs;
+            std::thread thread;
+            u32 random = 0;
+            // recycled jobs, used only by worker thread
+            JobNode* freeJobs = nullptr;
+            u32 freeCount = 0;
+        };
+
+        // returns index of calling thread in this scheduler or invalid_worker
+        inline u32 getWorkerIndex() const {
+            return t_Scheduler == this ? t_WorkerIndex : invalid_worker;
+        }
+
+        template<typename Function>
+        void submit(Function&& function);
+        void push(JobNode* job);
+        JobNode* allocateJob();
+        void freeJob(JobNode* job);
+        // m_SlabMutex must be locked
+        JobNode* popSharedJob();
+        // runs jobs until done() returns true, blocks while there is nothing to run or if calling thread can't help
+        template<typename Predicate>
+        void helpUntil(const Predicate& done);
+        // takes job from own deque, injection queue or steals it from random worker
+        JobNode* takeJob(u32 workerIndex);
+        void runJob(JobNode* job);
+        // wakes threads blocked in wait() or helpUntil(), if there are any
+        void notifyWaiters();
+        bool hasJobs();
+        // puts worker to sleep, until new job is submitted
+        void park();
+        // wakes single parked worker, if there is any
+        void wake();
+        void setupThread(u32 workerId, const ThreadFormat& threadFormat);
+        TimerHandle insertTimer(std::chrono::milliseconds delay, std::chrono::milliseconds period, const TimerFunction& function);
+        // m_TimerMutex must be locked
+        u64 currentTimerTick() const;
+        void runTimers();
 
     private:
-        RingBuffer<std::function<void()>, jobs_capacity> m_JobPool;
-        std::condition_variable m_WakeCondition;
+        static constexpr u32 invalid_worker = 0xffffffff;
+        static thread_local JobScheduler* t_Scheduler;
+        static thread_local u32 t_WorkerIndex;
+
+        RingBuffer<JobNode*, jobs_capacity> m_JobPool;
+        vector<Scope<Worker>> m_Workers;
+        // jobs memory, free jobs of threads outside of scheduler and jobs returned by workers
+        std::mutex m_SlabMutex;
+        vector<std::unique_ptr<JobNode[]>> m_Slabs;
+        JobNode* m_FreeJobs = nullptr;
+        u32 m_WorkerSize;
+        bool m_CallersHelp;
+        std::atomic<bool> m_Running { true };
+        // parked workers
         std::mutex m_WakeMutex;
-        u64 m_JobsTodo;
+        std::condition_variable m_WakeCondition;
+        std::atomic<u32> m_Sleepers { 0 };
+        u64 m_WakeEpoch = 0; // guarded by m_WakeMutex
+        // threads blocked in wait() and helpUntil()
+        std::mutex m_IdleMutex;
+        std::condition_variable m_IdleCondition;
+        std::atomic<u32> m_Waiters { 0 };
+        // jobs may be scheduled from worker threads too, e.g. by Registry::parallelEach()
+        std::atomic<u64> m_JobsTodo;
         std::atomic<u64> m_JobsDone;
+        // delayed and periodic jobs, wheel ticks are milliseconds since m_TimerStart
+        std::mutex m_TimerMutex;
+        std::condition_variable m_TimerCondition;
+        TimerWheel m_Timers;
+        std::thread m_TimerThread;
+        std::chrono::steady_clock::time_point m_TimerStart;
     };
 
+    template<size_t jobs_capacity>
+    thread_local JobScheduler<jobs_capacity>* JobScheduler<jobs_capacity>::t_Scheduler = nullptr;
+
+    template<size_t jobs_capacity>
+    thread_local u32 JobScheduler<jobs_capacity>::t_WorkerIndex = 0;
+
+    // machines with this or less logical CPUs run audio and network jobs in one lane
+    constexpr u32 job_system_small_cpus = 4;
+
     template<size_t render_jobs = 8,
             size_t audio_jobs = 8,
             size_t network_jobs = 8,
@@ -137,61 +582,159 @@ namespace engine::core {
     class JobSystem final {
 
     public:
-        JobSystem();
+        // pinThreads - render thread and pool workers are bound to separate physical cores, see thread::cpu_topology()
+        // pinned pool has at most one worker per core, which is not taken by render thread
+        explicit JobSystem(bool pinThreads = false);
 
     public:
         void waitAll();
 
+        [[nodiscard]] inline bool isSharedLane() const {
+            return m_SharedLane;
+        }
+
     public:
-        Scope<JobScheduler<render_jobs>> renderScheduler;
-        Scope<JobScheduler<audio_jobs>> audioScheduler;
-        Scope<JobScheduler<network_jobs>> networkScheduler;
-        Scope<JobScheduler<thread_pool_jobs>> threadPoolScheduler;
+        // audio and network schedulers are the same one on small machines, see isSharedLane()
+        JobScheduler<render_jobs>* renderScheduler = nullptr;
+        JobScheduler<audio_jobs>* audioScheduler = nullptr;
+        JobScheduler<network_jobs>* networkScheduler = nullptr;
+        JobScheduler<thread_pool_jobs>* threadPoolScheduler = nullptr;
+
+    private:
+        Scope<JobScheduler<render_jobs>> m_RenderScheduler;
+        Scope<JobScheduler<audio_jobs>> m_AudioScheduler;
+        Scope<JobScheduler<network_jobs>> m_NetworkScheduler;
+        Scope<JobScheduler<thread_pool_jobs>> m_ThreadPoolScheduler;
+        bool m_SharedLane = false;
     };
 
     template<size_t render_jobs,
             size_t audio_jobs,
             size_t network_jobs,
             size_t thread_pool_jobs>
-    JobSystem<render_jobs, audio_jobs, network_jobs, thread_pool_jobs>::JobSystem() {
-        // todo this code does not support 1 core CPU.
-        const u32 workerSize = std::max(1u, std::thread::hardware_concurrency());
-        u32 renderThreads = 1;
-        u32 audioThreads = 1;
-        u32 networkThreads = 1;
-        u32 poolThreads = workerSize - renderThreads - audioThreads - networkThreads;
-        ENGINE_ASSERT(workerSize > 3, "JobSystem(): invalid condition threadPoolSize <= 0");
-        renderScheduler = createScope<JobScheduler<render_jobs>>(renderThreads, ThreadFormat(ThreadPriority::HIGHEST, "RenderThread"));
-        audioScheduler = createScope<JobScheduler<audio_jobs>>(audioThreads, ThreadFormat(ThreadPriority::HIGHEST, "AudioThread"));
-        networkScheduler = createScope<JobScheduler<network_jobs>>(networkThreads, ThreadFormat(ThreadPriority::HIGHEST, "NetworkThread"));
-        threadPoolScheduler = createScope<JobScheduler<thread_pool_jobs>>(poolThreads, ThreadFormat(ThreadPriority::NORMAL, "ThreadPoolWorker"));
+    JobSystem<render_jobs, audio_jobs, network_jobs, thread_pool_jobs>::JobSystem(bool pinThreads) {
+        const thread::CpuTopology& topology = thread::cpu_topology();
+        // SMT siblings share execution units, so they count as half of a core
+        const u32 cores = topology.physicalCount + (topology.logicalCount - topology.physicalCount) / 2;
+        // main thread helps pool in waitFor() and render thread is busy each frame, audio and network mostly sleep
+        u32 poolThreads = cores > 3 ? cores - 2 : 1;
+        // pinned workers take first threads of cores after render core, so none of them runs on SMT sibling of render core
+        const u32 freeCores = topology.physicalCount - 1;
+        const bool pinPool = pinThreads && freeCores > 0;
+        if (pinPool) {
+            poolThreads = std::min(poolThreads, freeCores);
+        }
+        const s32 renderCpu = pinThreads ? 0 : -1;
+        const s32 poolCpu = pinPool ? 1 : -1;
+        // jobs of dedicated threads must not be run by waiting callers
+        m_RenderScheduler = createScope<JobScheduler<render_jobs>>(1, ThreadFormat(ThreadPriority::HIGHEST, "RenderThread", renderCpu), false);
+        if constexpr (audio_jobs == network_jobs) {
+            m_SharedLane = topology.logicalCount <= job_system_small_cpus;
+        }
+        if (m_SharedLane) {
+            m_AudioScheduler = createScope<JobScheduler<audio_jobs>>(1, ThreadFormat(ThreadPriority::HIGHEST, "AudioNetworkThread"), false);
+        } else {
+            m_AudioScheduler = createScope<JobScheduler<audio_jobs>>(1, ThreadFormat(ThreadPriority::HIGHEST, "AudioThread"), false);
+            m_NetworkScheduler = createScope<JobScheduler<network_jobs>>(1, ThreadFormat(ThreadPriority::HIGHEST, "NetworkThread"), false);
+        }
+        m_ThreadPoolScheduler = createScope<JobScheduler<thread_pool_jobs>>(poolThreads, ThreadFormat(ThreadPriority::NORMAL, "ThreadPoolWorker", poolCpu));
+
+        renderScheduler = m_RenderScheduler.get();
+        audioScheduler = m_AudioScheduler.get();
+        if constexpr (audio_jobs == network_jobs) {
+            networkScheduler = m_SharedLane ? audioScheduler : m_NetworkScheduler.get();
+        } else {
+            networkScheduler = m_NetworkScheduler.get();
+        }
+        threadPoolScheduler = m_ThreadPoolScheduler.get();
+        ENGINE_INFO("JobSystem: {0} logical CPUs, {1} cores, {2} pool workers, shared audio/network lane: {3}, pinned: {4}",
+                    topology.logicalCount, topology.physicalCount, poolThreads, m_SharedLane, pinThreads);
     }
 
     template<size_t render_jobs, size_t audio_jobs, size_t network_jobs, size_t thread_pool_jobs>
     void JobSystem<render_jobs, audio_jobs, network_jobs, thread_pool_jobs>::waitAll() {
         renderScheduler->wait();
         audioScheduler->wait();
-        networkScheduler->wait();
+        if (!m_SharedLane) {
+            networkScheduler->wait();
+        }
         threadPoolScheduler->wait();
     }
 
     template<size_t jobs_capacity>
-    JobScheduler<jobs_capacity>::JobScheduler(u32 workerSize, const ThreadFormat& threadFormat) {
-        m_JobsTodo = 0;
+    JobScheduler<jobs_capacity>::JobScheduler(u32 workerSize, const ThreadFormat& threadFormat, bool callersHelp) {
+        m_WorkerSize = workerSize;
+        m_CallersHelp = callersHelp;
+        m_JobsTodo.store(0);
         m_JobsDone.store(0);
-        for (int i = 0; i < workerSize ; i++) {
+        // all deques must exist before any worker starts stealing
+        for (u32 i = 0; i < workerSize ; i++) {
+            m_Workers.emplace_back(createScope<Worker>());
+            m_Workers.back()->random = i + 1;
+        }
+        for (u32 i = 0; i < workerSize ; i++) {
             setupThread(i, threadFormat);
         }
     }
 
     template<size_t jobs_capacity>
-    void JobScheduler<jobs_capacity>::execute(const std::function<void()> &job) {
-        m_JobsTodo += 1;
-        // try to push a new job until it is pushed
-        while (!m_JobPool.pushBack(job)) {
-            poll();
+    JobScheduler<jobs_capacity>::~JobScheduler() {
+        m_Running.store(false);
+        // timer thread submits jobs, so it stops first
+        {
+            std::lock_guard<std::mutex> lock(m_TimerMutex);
+        }
+        m_TimerCondition.notify_all();
+        if (m_TimerThread.joinable()) {
+            m_TimerThread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_WakeEpoch++;
+        }
+        m_WakeCondition.notify_all();
+        for (auto& worker : m_Workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+        // jobs, that were never taken, their memory is released with slabs
+        JobNode* job;
+        while (m_JobPool.popFront(job)) {
+            job->job.reset();
+        }
+        for (auto& worker : m_Workers) {
+            while (worker->jobs.pop(job)) {
+                job->job.reset();
+            }
         }
-        m_WakeCondition.notify_one();
+    }
+
+    template<size_t jobs_capacity>
+    template<typename Function>
+    JobHandle JobScheduler<jobs_capacity>::execute(Function&& job) {
+        Ref<JobCounter> counter = createRef<JobCounter>(1);
+        m_JobsTodo.fetch_add(1);
+        submit([job = std::forward<Function>(job), counter]() mutable {
+            job();
+            counter->complete();
+        });
+        return JobHandle(counter);
+    }
+
+    template<size_t jobs_capacity>
+    template<typename Function>
+    JobHandle JobScheduler<jobs_capacity>::execute(const JobHandle& dependency, Function&& job) {
+        Ref<JobCounter> counter = createRef<JobCounter>(1);
+        // counted right away, so wait() also waits for jobs, which dependencies are not done yet
+        m_JobsTodo.fetch_add(1);
+        dependency.then([this, job = std::forward<Function>(job), counter]() {
+            submit([job, counter]() mutable {
+                job();
+                counter->complete();
+            });
+        });
+        return JobHandle(counter);
     }
 
     template<size_t jobs_capacity>
@@ -201,10 +744,12 @@ namespace engine::core {
         }
 
         u32 jobGroups = (jobsPerThread + jobSize - 1) / jobSize;
-        m_JobsTodo += jobGroups;
+        m_JobsTodo.fetch_add(jobGroups);
+        // groups share single copy of job, so every group fits into job inline storage
+        Ref<std::function<void(JobArgs)>> sharedJob = createRef<std::function<void(JobArgs)>>(job);
         for (u32 i = 0; i < jobGroups; ++i) {
             // create single job from group
-            const auto& jobGroup = [i, job, jobSize, jobsPerThread]() {
+            submit([i, sharedJob, jobSize, jobsPerThread]() {
 
                 u32 groupJobOffset = i * jobSize;
                 u32 groupJobEnd = std::min(groupJobOffset + jobSize, jobsPerThread);
@@ -214,52 +759,379 @@ namespace engine::core {
 
                 for (u32 j = groupJobOffset; j < groupJobEnd; ++j) {
                     args.index = j;
-                    job(args);
+                    (*sharedJob)(args);
                 }
-            };
-            // try to push new group as a job until its pushed
-            while (!m_JobPool.pushBack(jobGroup)) {
-                poll();
+            });
+        }
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::parallelFor(u32 count, u32 groupSize, const std::function<void(JobArgs)>& job) {
+        if (count == 0 || groupSize == 0) {
+            return;
+        }
+
+        // state is shared with worker jobs, which may start after all groups are already done
+        struct ParallelState {
+            u32 groupCount;
+            std::atomic<u32> next { 0 };
+            std::atomic<u32> done { 0 };
+        };
+        Ref<ParallelState> state = createRef<ParallelState>();
+        state->groupCount = (count + groupSize - 1) / groupSize;
+
+        // takes groups until there are none left, job is touched only while its group is not done
+        const std::function<void(JobArgs)>* jobPtr = &job;
+        auto processGroups = [jobPtr, count, groupSize](ParallelState& state) {
+            u32 i;
+            while ((i = state.next.fetch_add(1)) < state.groupCount) {
+                JobArgs args;
+                args.groupIndex = i;
+                u32 groupEnd = std::min(i * groupSize + groupSize, count);
+                for (u32 j = i * groupSize ; j < groupEnd ; j++) {
+                    args.index = j;
+                    (*jobPtr)(args);
+                }
+                state.done.fetch_add(1);
             }
-            m_WakeCondition.notify_one();
+        };
+
+        u32 helpers = std::min(state->groupCount - 1, m_WorkerSize);
+        m_JobsTodo.fetch_add(helpers);
+        for (u32 i = 0 ; i < helpers ; i++) {
+            submit([state, processGroups]() {
+                processGroups(*state);
+            });
         }
+
+        processGroups(*state);
+        helpUntil([&state]() {
+            return state->done.load() == state->groupCount;
+        });
     }
 
     template<size_t jobs_capacity>
     bool JobScheduler<jobs_capacity>::isBusy() {
-        return m_JobsDone.load() < m_JobsTodo;
+        return m_JobsDone.load() < m_JobsTodo.load();
     }
 
     template<size_t jobs_capacity>
     void JobScheduler<jobs_capacity>::wait() {
-        while (isBusy()) {
-            poll();
+        if (!isBusy()) return;
+
+        m_Waiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_IdleMutex);
+            m_IdleCondition.wait(lock, [this]() { return !isBusy(); });
+        }
+        m_Waiters.fetch_sub(1);
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::waitFor(const JobHandle& handle) {
+        helpUntil([&handle]() {
+            return handle.isDone();
+        });
+    }
+
+    template<size_t jobs_capacity>
+    template<typename Predicate>
+    void JobScheduler<jobs_capacity>::helpUntil(const Predicate& done) {
+        if (done()) return;
+
+        u32 workerIndex = getWorkerIndex();
+        if (workerIndex == invalid_worker && !m_CallersHelp) {
+            // every finished job notifies waiters, so condition is checked again after each of them
+            m_Waiters.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(m_IdleMutex);
+                m_IdleCondition.wait(lock, done);
+            }
+            m_Waiters.fetch_sub(1);
+            return;
+        }
+
+        while (!done()) {
+            JobNode* job = takeJob(workerIndex);
+            if (job) {
+                runJob(job);
+                continue;
+            }
+            // nothing to help with, so sleep until new job is pushed or some job is finished
+            m_Waiters.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(m_IdleMutex);
+                m_IdleCondition.wait(lock, [this, &done]() { return done() || hasJobs(); });
+            }
+            m_Waiters.fetch_sub(1);
         }
     }
 
     template<size_t jobs_capacity>
-    void JobScheduler<jobs_capacity>::poll() {
+    template<typename Function>
+    void JobScheduler<jobs_capacity>::submit(Function&& function) {
+        JobNode* job = allocateJob();
+        job->job.set(std::forward<Function>(function));
+        push(job);
+    }
+
+    template<size_t jobs_capacity>
+    typename JobScheduler<jobs_capacity>::JobNode* JobScheduler<jobs_capacity>::allocateJob() {
+        u32 workerIndex = getWorkerIndex();
+        if (workerIndex == invalid_worker) {
+            std::lock_guard<std::mutex> lock(m_SlabMutex);
+            return popSharedJob();
+        }
+
+        Worker& worker = *m_Workers[workerIndex];
+        if (!worker.freeJobs) {
+            // take a batch of free jobs, so lock is taken once per batch
+            std::lock_guard<std::mutex> lock(m_SlabMutex);
+            for (u32 i = 0 ; i < job_slab_size ; i++) {
+                JobNode* job = popSharedJob();
+                job->next = worker.freeJobs;
+                worker.freeJobs = job;
+            }
+            worker.freeCount += job_slab_size;
+        }
+        JobNode* job = worker.freeJobs;
+        worker.freeJobs = job->next;
+        worker.freeCount--;
+        return job;
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::freeJob(JobNode* job) {
+        job->job.reset();
+        u32 workerIndex = getWorkerIndex();
+        if (workerIndex == invalid_worker) {
+            std::lock_guard<std::mutex> lock(m_SlabMutex);
+            job->next = m_FreeJobs;
+            m_FreeJobs = job;
+            return;
+        }
+
+        // jobs are freed by workers, that run them, so free jobs may pile up at one worker
+        Worker& worker = *m_Workers[workerIndex];
+        job->next = worker.freeJobs;
+        worker.freeJobs = job;
+        if (++worker.freeCount > 2 * job_slab_size) {
+            std::lock_guard<std::mutex> lock(m_SlabMutex);
+            for (u32 i = 0 ; i < job_slab_size ; i++) {
+                JobNode* returned = worker.freeJobs;
+                worker.freeJobs = returned->next;
+                returned->next = m_FreeJobs;
+                m_FreeJobs = returned;
+            }
+            worker.freeCount -= job_slab_size;
+        }
+    }
+
+    template<size_t jobs_capacity>
+    typename JobScheduler<jobs_capacity>::JobNode* JobScheduler<jobs_capacity>::popSharedJob() {
+        if (!m_FreeJobs) {
+            std::unique_ptr<JobNode[]> slab(new JobNode[job_slab_size]);
+            for (u32 i = 0 ; i + 1 < job_slab_size ; i++) {
+                slab[i].next = &slab[i + 1];
+            }
+            m_FreeJobs = &slab[0];
+            m_Slabs.emplace_back(std::move(slab));
+        }
+        JobNode* job = m_FreeJobs;
+        m_FreeJobs = job->next;
+        return job;
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::push(JobNode* job) {
+        u32 workerIndex = getWorkerIndex();
+        if (workerIndex != invalid_worker) {
+            if (!m_Workers[workerIndex]->jobs.push(job) && !m_JobPool.pushBack(job)) {
+                // worker can't wait for free space, because it may be the only one who frees it
+                runJob(job);
+                return;
+            }
+        } else {
+            // try to push a new job until it is pushed
+            while (!m_JobPool.pushBack(job)) {
+                wake();
+                std::this_thread::yield();
+            }
+        }
+        wake();
+        // pushed job must be visible before waiters are checked, as helping waiters check for jobs after they are counted
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        notifyWaiters();
+    }
+
+    template<size_t jobs_capacity>
+    typename JobScheduler<jobs_capacity>::JobNode* JobScheduler<jobs_capacity>::takeJob(u32 workerIndex) {
+        JobNode* job = nullptr;
+        if (workerIndex != invalid_worker && m_Workers[workerIndex]->jobs.pop(job)) {
+            return job;
+        }
+        if (m_JobPool.popFront(job)) {
+            return job;
+        }
+
+        // xorshift picks first victim, then others are checked in order
+        u32 workerCount = (u32) m_Workers.size();
+        u32 random = workerIndex != invalid_worker ? m_Workers[workerIndex]->random : (u32) m_JobsTodo.load(std::memory_order_relaxed) + 1;
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        if (workerIndex != invalid_worker) {
+            m_Workers[workerIndex]->random = random;
+        }
+        for (u32 i = 0 ; i < workerCount ; i++) {
+            u32 victim = (random + i) % workerCount;
+            if (victim != workerIndex && m_Workers[victim]->jobs.steal(job)) {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::runJob(JobNode* job) {
+        job->job();
+        freeJob(job);
+        m_JobsDone.fetch_add(1);
+        notifyWaiters();
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::notifyWaiters() {
+        if (m_Waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(m_IdleMutex);
+            m_IdleCondition.notify_all();
+        }
+    }
+
+    template<size_t jobs_capacity>
+    bool JobScheduler<jobs_capacity>::hasJobs() {
+        if (!m_JobPool.isEmpty()) {
+            return true;
+        }
+        for (const auto& worker : m_Workers) {
+            if (!worker->jobs.isEmpty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::park() {
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        u64 epoch = m_WakeEpoch;
+        // announce sleep before the last check, so job submitted after the check always wakes this worker
+        m_Sleepers.fetch_add(1);
+        if (m_Running.load() && !hasJobs()) {
+            m_WakeCondition.wait(lock, [this, epoch]() { return m_WakeEpoch != epoch; });
+        }
+        m_Sleepers.fetch_sub(1);
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::wake() {
+        if (m_Sleepers.load() == 0) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_WakeEpoch++;
+        }
         m_WakeCondition.notify_one();
-        std::this_thread::yield();
     }
 
     template<size_t jobs_capacity>
-    void JobScheduler<jobs_capacity>::setupThread(int workerId, const ThreadFormat& threadFormat) {
-        std::thread worker([this]() {
-            std::function<void()> job;
-            while (true) {
-                if (m_JobPool.popFront(job)) {
-                    // execute job and update worker label state
-                    job();
-                    m_JobsDone.fetch_add(1);
+    template<typename Function>
+    TimerHandle JobScheduler<jobs_capacity>::executeAfter(std::chrono::milliseconds delay, Function&& job) {
+        return insertTimer(delay, std::chrono::milliseconds(0), createRef<std::function<void()>>(std::forward<Function>(job)));
+    }
+
+    template<size_t jobs_capacity>
+    template<typename Function>
+    TimerHandle JobScheduler<jobs_capacity>::executeEvery(std::chrono::milliseconds period, Function&& job) {
+        ENGINE_ASSERT(period.count() > 0, "executeEvery() -> period must be positive!");
+        return insertTimer(period, period, createRef<std::function<void()>>(std::forward<Function>(job)));
+    }
+
+    template<size_t jobs_capacity>
+    bool JobScheduler<jobs_capacity>::cancelTimer(const TimerHandle& handle) {
+        std::lock_guard<std::mutex> lock(m_TimerMutex);
+        return m_Timers.cancel(handle);
+    }
+
+    template<size_t jobs_capacity>
+    TimerHandle JobScheduler<jobs_capacity>::insertTimer(
+            std::chrono::milliseconds delay,
+            std::chrono::milliseconds period,
+            const TimerFunction& function
+    ) {
+        TimerHandle handle;
+        {
+            std::lock_guard<std::mutex> lock(m_TimerMutex);
+            if (!m_TimerThread.joinable()) {
+                m_TimerStart = std::chrono::steady_clock::now();
+                m_TimerThread = std::thread([this]() { runTimers(); });
+                setThreadFormat(0, m_TimerThread, ThreadFormat(ThreadPriority::HIGHEST, "JobTimer"));
+            }
+            // wheel stays behind while its thread sleeps, so delay is counted from now
+            u64 now = currentTimerTick();
+            u64 behind = now > m_Timers.getTick() ? now - m_Timers.getTick() : 0;
+            handle = m_Timers.insert(behind + (u64) std::max<s64>(delay.count(), 0), (u64) period.count(), function);
+        }
+        m_TimerCondition.notify_one();
+        return handle;
+    }
+
+    template<size_t jobs_capacity>
+    u64 JobScheduler<jobs_capacity>::currentTimerTick() const {
+        return (u64) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_TimerStart).count();
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::runTimers() {
+        vector<TimerFunction> expired;
+        std::unique_lock<std::mutex> lock(m_TimerMutex);
+        while (m_Running.load()) {
+            m_Timers.advance(currentTimerTick(), expired);
+            if (!expired.empty()) {
+                // jobs are submitted without lock, so they may schedule timers too
+                lock.unlock();
+                for (TimerFunction& function : expired) {
+                    execute([function]() { (*function)(); });
+                }
+                expired.clear();
+                lock.lock();
+                continue;
+            }
+            if (m_Timers.size() == 0) {
+                m_TimerCondition.wait(lock);
+            } else {
+                u64 wakeTick = m_Timers.getTick() + m_Timers.ticksToNextEvent();
+                m_TimerCondition.wait_until(lock, m_TimerStart + std::chrono::milliseconds(wakeTick));
+            }
+        }
+    }
+
+    template<size_t jobs_capacity>
+    void JobScheduler<jobs_capacity>::setupThread(u32 workerId, const ThreadFormat& threadFormat) {
+        Worker& worker = *m_Workers[workerId];
+        worker.thread = std::thread([this, workerId]() {
+            t_Scheduler = this;
+            t_WorkerIndex = workerId;
+            while (m_Running.load(std::memory_order_acquire)) {
+                JobNode* job = takeJob(workerId);
+                if (job) {
+                    runJob(job);
                 } else {
                     // no job, put thread to sleep
-                    std::unique_lock<std::mutex> lock(m_WakeMutex);
-                    m_WakeCondition.wait(lock);
+                    park();
                 }
             }
         });
-        thread::setThreadFormat(workerId, worker, threadFormat);
-        worker.detach();
+        thread::setThreadFormat(workerId, worker.thread, threadFormat);
     }
 }
\ No newline at end of file
@@ -4,24 +4,30 @@
 
 #pragma once
 
-#define STL_MAP 1
+#include <map>
 
-#ifdef STL_MAP
+#ifdef STL_UNORDERED_MAP
 // STL implementation
-#include <map>
 #include <unordered_map>
+#include <unordered_set>
 namespace engine::core {
     template<typename K, typename V>
     using map = std::map<K,V>;
     template<typename K, typename V>
     using unordered_map = std::unordered_map<K,V>;
+    template<typename K>
+    using unordered_set = std::unordered_set<K>;
 }
 #else
 // My implementation
+#include <core/flat_map.h>
 namespace engine::core {
     template<typename K, typename V>
-    class map {};
+    using map = std::map<K,V>;
+    // insert may move values, so references into unordered containers must not be kept across inserts
     template<typename K, typename V>
-    class unordered_map {};
+    using unordered_map = flat_map<K,V>;
+    template<typename K>
+    using unordered_set = flat_set<K>;
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,87 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <core/core.h>
+#include <core/primitives.h>
+#include <core/Memory.h>
+#include <core/vector.h>
+
+#include <functional>
+
+namespace engine::core {
+
+    // each level of timer wheel covers timer_wheel_slots times more ticks than previous one
+    constexpr u32 timer_wheel_levels = 4;
+    constexpr u32 timer_wheel_slot_bits = 6;
+    constexpr u32 timer_wheel_slots = 1 << timer_wheel_slot_bits;
+    constexpr u32 invalid_timer_index = UINT32_MAX;
+
+    // timer handles are generational, so handles of fired or cancelled timers become stale
+    struct ENGINE_API TimerHandle {
+        u32 index = invalid_timer_index;
+        u32 generation = 0;
+
+        [[nodiscard]] inline bool isValid() const {
+            return index != invalid_timer_index;
+        }
+    };
+
+    typedef Ref<std::function<void()>> TimerFunction;
+
+    // Hierarchical timer wheel with O(1) insert and cancel.
+    // Timers are linked into slots by their expiry tick, far timers live on higher levels
+    // and cascade into lower levels, each time lower level wraps.
+    // It's not thread safe, owner must guard it, see JobScheduler.
+    class ENGINE_API TimerWheel final {
+
+    public:
+        TimerWheel();
+
+    public:
+        // fires function after delay ticks, then every period ticks, if period is not 0
+        TimerHandle insert(u64 delay, u64 period, const TimerFunction& function);
+        // returns false, if timer has already fired or was cancelled
+        bool cancel(const TimerHandle& handle);
+        // moves wheel up to tick and collects functions of expired timers
+        // periodic timers are linked again and fire at most once per advance()
+        void advance(u64 tick, vector<TimerFunction>& expired);
+        // ticks from current one, until wheel has to be advanced, never more than timer_wheel_slots
+        [[nodiscard]] u64 ticksToNextEvent() const;
+
+        [[nodiscard]] inline u64 getTick() const {
+            return m_Tick;
+        }
+
+        [[nodiscard]] inline u32 size() const {
+            return m_Size;
+        }
+
+    private:
+        struct Timer {
+            u64 expiry = 0;
+            u64 period = 0;
+            TimerFunction function;
+            u32 generation = 0;
+            u32 prev = invalid_timer_index;
+            // next timer in slot, or next free timer
+            u32 next = invalid_timer_index;
+            u32 slot = invalid_timer_index;
+        };
+
+        void link(u32 index);
+        void unlink(u32 index);
+        void release(u32 index);
+        void cascade(u32 level);
+
+    private:
+        vector<Timer> m_Timers;
+        u32 m_FreeTimer = invalid_timer_index;
+        u32 m_Slots[timer_wheel_levels * timer_wheel_slots];
+        u64 m_Tick = 0;
+        u32 m_Size = 0;
+    };
+
+}
@@ -13,6 +13,9 @@ namespace engine::ecs {
 
     class ENGINE_API EntityContainer {
 
+    public:
+        EntityContainer();
+
     public:
         void clear();
         [[nodiscard]] bool isEmpty();
@@ -27,6 +30,10 @@ namespace engine::ecs {
             return registry;
         }
 
+        [[nodiscard]] inline bool isAlive(const entity_id& entityId) const {
+            return registry.isAlive(entityId);
+        }
+
     public:
         template<typename T, typename... Args>
         inline bool addComponent(const entity_id& entityId, Args &&... args) {
@@ -35,9 +42,7 @@ namespace engine::ecs {
 
         template<typename T, typename... Args>
         inline bool updateComponent(const entity_id& entityId, Args &&... args) {
-            bool removed = registry.removeComponent<T>(entityId);
-            registry.addComponent<T>(entityId, std::forward<Args>(args)...);
-            return removed;
+            return registry.updateComponent<T>(entityId, std::forward<Args>(args)...);
         }
 
         template<typename T>
@@ -47,7 +52,7 @@ namespace engine::ecs {
 
         template<typename T>
         inline bool hasComponent(const entity_id& entityId) {
-            return registry.getComponent<T>(entityId);
+            return registry.hasComponent<T>(entityId);
         }
 
         template<typename T>
@@ -55,6 +60,9 @@ namespace engine::ecs {
             return registry.removeComponent<T>(entityId);
         }
 
+        // O(1) lookup of entity by UUIDComponent, returns invalid_entity_id if nobody has this uuid
+        [[nodiscard]] entity_id findEntityId(int uuid) const;
+
         template<typename T>
         T* findComponent(const uuid& uuid);
 
@@ -65,6 +73,8 @@ namespace engine::ecs {
         T* findComponent(u64 uuid);
 
     protected:
+        // declared before registry, because registry calls removed hooks on destruction
+        unordered_map<int, entity_id> uuidIndex;
         Registry registry;
 
         friend class Entity;
@@ -72,9 +82,8 @@ namespace engine::ecs {
 
     template<typename T>
     T* EntityContainer::findComponent(const UUIDComponent &uuid) {
-        return registry.findComponent<UUIDComponent, T>([&uuid](UUIDComponent* found) {
-            return *found == uuid;
-        });
+        entity_id entityId = findEntityId(uuid.uuid);
+        return entityId == invalid_entity_id ? nullptr : registry.getComponent<T>(entityId);
     }
 
     template<typename T>
@@ -108,7 +117,7 @@ namespace engine::ecs {
         }
 
     public:
-        [[nodiscard]] inline void* getId() const {
+        [[nodiscard]] inline entity_id getId() const {
             return id;
         }
 
@@ -120,8 +129,13 @@ namespace engine::ecs {
             return container;
         }
 
+        inline void setContainer(EntityContainer* newContainer) {
+            container = newContainer;
+        }
+
+        // false also for handles of entities, that were already deleted from container
         [[nodiscard]] inline bool isValid() const {
-            return id != invalid_entity_id;
+            return container && container->isAlive(id);
         }
 
         [[nodiscard]] inline const uuid& getUUID() const {
@@ -148,7 +162,6 @@ namespace engine::ecs {
     public:
         explicit operator const entity_id&() const { return id; }
         explicit operator bool() const { return id != invalid_entity_id; }
-        explicit operator void *() const { return id; }
 
         bool operator==(const Entity& other) const {
             return id == other.id && container == other.container;
@@ -0,0 +1,111 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <ecs/ecs.h>
+#include <core/job_system.h>
+
+namespace engine::ecs {
+
+    // components that system reads and writes
+    // exclusive system may touch anything, so it never runs together with other systems
+    struct ENGINE_API SystemAccess {
+        archetype_signature reads;
+        archetype_signature writes;
+        bool exclusive = false;
+
+        template<class... Components>
+        inline SystemAccess& read() {
+            (reads.emplace_back(Components::ID), ...);
+            return *this;
+        }
+
+        template<class... Components>
+        inline SystemAccess& write() {
+            (writes.emplace_back(Components::ID), ...);
+            return *this;
+        }
+
+        inline SystemAccess& makeExclusive() {
+            exclusive = true;
+            return *this;
+        }
+
+        // true if one of systems writes component, which another one reads or writes
+        [[nodiscard]] bool conflicts(const SystemAccess& other) const;
+    };
+
+    struct ENGINE_API System {
+        std::string name;
+        std::function<void()> update;
+        SystemAccess access;
+    };
+
+    // runs systems once per frame, systems with conflicting access run in the order they were added
+    // and others run at the same time on scheduler workers, so systems don't need any locking of components
+    class ENGINE_API SystemScheduler final {
+        IMMUTABLE(SystemScheduler)
+    public:
+        SystemScheduler() = default;
+
+    public:
+        // returns access of added system, which is used to declare its components
+        // reference is valid until the next addSystem() call
+        SystemAccess& addSystem(const std::string& name, const std::function<void()>& update);
+        void clear();
+
+        [[nodiscard]] inline size_t size() const {
+            return systems.size();
+        }
+
+        // runs all systems and returns when they are done, dependency graph is built from access declared by this time
+        // systems are scheduler jobs, so waiting threads run nested jobs of systems too
+        // and it's safe to call it from worker thread of the same scheduler
+        template<typename Scheduler>
+        void run(Scheduler& scheduler);
+
+    private:
+        // builds graph and resets frame state, returns false if there is nothing to run
+        bool prepare();
+        // runs system as a job, which submits dependents released by it
+        template<typename Scheduler>
+        void submit(Scheduler& scheduler, u32 system, const Ref<JobCounter>& frame);
+
+    private:
+        vector<System> systems;
+        // dependency graph: systems that wait for system i and count of systems that system i waits for
+        vector<vector<u32>> dependents;
+        vector<u32> dependencies;
+        // frame state
+        std::unique_ptr<std::atomic<u32>[]> pending;
+    };
+
+    template<typename Scheduler>
+    void SystemScheduler::run(Scheduler& scheduler) {
+        if (!prepare()) return;
+
+        // done, when every system is done
+        Ref<JobCounter> frame = createRef<JobCounter>((u32) systems.size());
+        for (u32 i = 0 ; i < systems.size() ; i++) {
+            if (dependencies[i] == 0) {
+                submit(scheduler, i, frame);
+            }
+        }
+        scheduler.waitFor(JobHandle(frame));
+    }
+
+    template<typename Scheduler>
+    void SystemScheduler::submit(Scheduler& scheduler, u32 system, const Ref<JobCounter>& frame) {
+        scheduler.execute([this, &scheduler, system, frame]() {
+            systems[system].update();
+            for (u32 dependent : dependents[system]) {
+                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    submit(scheduler, dependent, frame);
+                }
+            }
+            frame->complete();
+        });
+    }
+}
@@ -6,49 +6,85 @@
 
 #include <core/identifier.h>
 #include <core/vector.h>
+#include <core/map.h>
+#include <core/Memory.h>
 #include <map>
+#include <unordered_map>
+#include <functional>
 #include <time/Time.h>
 #include <core/immutable.h>
 #include <tuple>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <type_traits>
+#include <cstring>
 #include <serialization/serialization.h>
 
 namespace engine::ecs {
 
     using namespace core;
     // type identifiers for entities and components
-    #define invalid_entity_id nullptr
-    typedef void* entity_id;
+    // entity id is a handle: [generation: 32 bits][index: 32 bits]
+    // index points into Registry entity table, generation is bumped each time entity with this index is deleted,
+    // so stale handles of deleted entities never match a live entity again
+    typedef u64 entity_id;
     typedef u32 component_id;
     typedef size_t component_size;
-    typedef vector<u8> component_data; // components raw storage in bytes
+    #define invalid_entity_id engine::ecs::entity_id(0) // generation starts from 1, so 0 is never a valid handle
+
+    constexpr u32 entity_index(entity_id entityId) {
+        return (u32) (entityId & 0xffffffff);
+    }
+
+    constexpr u32 entity_generation(entity_id entityId) {
+        return (u32) (entityId >> 32);
+    }
+
+    constexpr entity_id make_entity_id(u32 index, u32 generation) {
+        return ((entity_id) generation << 32) | index;
+    }
 
     struct BaseComponent;
-    typedef u32 (*ComponentCreateFunction)(component_data& data, entity_id entityId, BaseComponent* component);
+    typedef void (*ComponentCreateFunction)(void* data, entity_id entityId, BaseComponent* component);
     typedef void (*ComponentDestroyFunction)(BaseComponent* component);
+    // moves component into uninitialized data and destroys source component
+    // nullptr for trivially copyable components, which are relocated with memcpy
+    typedef void (*ComponentRelocateFunction)(void* data, BaseComponent* component);
 
     // meta-data of any "component" type
     struct ComponentType {
         ComponentCreateFunction createFunction;
         ComponentDestroyFunction destroyFunction;
+        ComponentRelocateFunction relocateFunction;
         component_size size;
+        u64 hash;
         const char* name;
 
         ComponentType(
                 ComponentCreateFunction createFunction,
                 ComponentDestroyFunction destroyFunction,
+                ComponentRelocateFunction relocateFunction,
                 component_size size,
+                u64 hash,
                 const char* name
-        ) : createFunction(createFunction), destroyFunction(destroyFunction), size(size), name(name) {}
+        ) : createFunction(createFunction), destroyFunction(destroyFunction), relocateFunction(relocateFunction),
+        size(size), hash(hash), name(name) {}
     };
 
     struct ENGINE_API BaseComponent {
         entity_id entityId = invalid_entity_id;
 
     public:
+        // returns id of already registered type with the same hash, so type registered from different modules gets single id
         static component_id registerComponentType(
                 ComponentCreateFunction createFunction,
                 ComponentDestroyFunction destroyFunction,
+                ComponentRelocateFunction relocateFunction,
                 component_size size,
+                u64 typeHash,
                 const char* typeName
         );
 
@@ -65,6 +101,10 @@ namespace engine::ecs {
             return componentTypes->at(id).destroyFunction;
         }
 
+        inline static ComponentRelocateFunction getRelocateFunction(component_id id) {
+            return componentTypes->at(id).relocateFunction;
+        }
+
         inline static component_size getSize(component_id id) {
             return componentTypes->at(id).size;
         }
@@ -84,6 +124,7 @@ namespace engine::ecs {
 
     private:
         static vector<ComponentType>* componentTypes;
+        static unordered_map<u64, component_id>* componentIds; // type hash -> component id
     };
 
     // Component
@@ -110,13 +151,10 @@ template<typename template_type>                          \
 struct component_type : engine::ecs::Component<component_type<template_type>>
 
     template<class Component>
-    u32 createComponent(component_data& data, entity_id entityId, BaseComponent* component) {
-        u32 componentIndex = data.size();
-        data.resize(componentIndex + Component::TYPE_SIZE);
-        // we use new() operator here to just set component_data in memory, rather than allocate it!
-        auto* newComponent = new(&data[componentIndex]) Component(*(Component*) component);
+    void createComponent(void* data, entity_id entityId, BaseComponent* component) {
+        // we use new() operator here to just set component data in memory, rather than allocate it!
+        auto* newComponent = new(data) Component(*(Component*) component);
         newComponent->entityId = entityId;
-        return componentIndex;
     }
 
     template<class Component>
@@ -124,9 +162,22 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
         ((Component*) component)->~Component();
     }
 
+    template<class Component>
+    void relocateComponent(void* data, BaseComponent* component) {
+        auto* newComponent = new(data) Component(std::move(*(Component*) component));
+        // custom move constructors may not move base part of component
+        newComponent->entityId = component->entityId;
+        ((Component*) component)->~Component();
+    }
+
+    template<class Component>
+    constexpr ComponentRelocateFunction relocate_function() {
+        return std::is_trivially_copyable_v<Component> ? nullptr : relocateComponent<Component>;
+    }
+
     template<class T>
     const component_id Component<T>::ID(BaseComponent::registerComponentType(
-            createComponent<T>, destroyComponent<T>, sizeof(T), typeid(T).name()
+            createComponent<T>, destroyComponent<T>, relocate_function<T>(), sizeof(T), type_hash<T>(), typeid(T).name()
     ));
 
     template<class T>
@@ -138,8 +189,296 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
     template<class T>
     const ComponentDestroyFunction Component<T>::destroyFunction(destroyComponent<T>);
 
-    typedef vector<std::pair<component_id, u32>> entity_data; // array of [componentId, componentIndex]
-    typedef std::pair<u32, entity_data> entity; // entity index -> entity data
+    // Archetype
+
+    // size of single memory block of archetype storage
+    constexpr component_size archetype_chunk_size = kb_16;
+    // alignment of each component column inside chunk
+    constexpr component_size archetype_column_alignment = 16;
+    constexpr u32 archetype_chunks_per_page = 16;
+
+    // chunks of all archetypes, it's shared by registries, so memory of cleared archetypes is reused by others
+    // chunks bigger than archetype_chunk_size come from heap_allocator(MemoryTag::ECS)
+    ENGINE_API PoolAllocator& archetype_chunk_pool();
+
+    class Archetype;
+    typedef vector<component_id> archetype_signature; // sorted array of component ids
+
+    constexpr u32 invalid_entity_index = 0xffffffff;
+
+    // record of entity table: generation of handle and location of entity components inside archetype storage
+    // archetype is nullptr for deleted records, they are linked into free list through nextFree
+    struct entity {
+        u32 generation = 1;
+        u32 chunk = 0;
+        u32 row = 0;
+        u32 nextFree = invalid_entity_index;
+        Archetype* archetype = nullptr;
+    };
+
+    // write version of component slot, see Registry::nextVersion()
+    typedef u64 component_version;
+
+    // fixed-size memory block, which stores entity ids and components of each type as separate arrays (SoA)
+    // [entity_id * capacity][Component1 * capacity][Component2 * capacity]...
+    // followed by changed and added versions of each component: [changed1 * capacity][added1 * capacity]...
+    struct ArchetypeChunk {
+        u8* data = nullptr;
+        u32 size = 0;
+    };
+
+    // storage of all entities with the same set of components
+    // entities are kept densely packed: every chunk except the last one is full
+    class ENGINE_API Archetype final {
+        IMMUTABLE(Archetype)
+    public:
+        explicit Archetype(const archetype_signature& signature);
+        ~Archetype();
+
+    public:
+        [[nodiscard]] inline const archetype_signature& getSignature() const {
+            return signature;
+        }
+
+        [[nodiscard]] inline u32 getEntityCount() const {
+            return entityCount;
+        }
+
+        [[nodiscard]] inline u32 getChunkCapacity() const {
+            return chunkCapacity;
+        }
+
+        [[nodiscard]] inline size_t getChunkCount() const {
+            return chunks.size();
+        }
+
+        inline ArchetypeChunk& getChunk(size_t index) {
+            return chunks[index];
+        }
+
+        inline entity_id* getEntities(const ArchetypeChunk& chunk) {
+            return (entity_id*) chunk.data;
+        }
+
+        inline u8* getColumnData(const ArchetypeChunk& chunk, u32 column) {
+            return chunk.data + offsets[column];
+        }
+
+        inline u8* getComponentData(u32 chunk, u32 row, u32 column) {
+            return chunks[chunk].data + offsets[column] + row * sizes[column];
+        }
+
+        inline component_version* getChangedVersions(const ArchetypeChunk& chunk, u32 column) {
+            return (component_version*) (chunk.data + versionOffsets[column]);
+        }
+
+        inline component_version* getAddedVersions(const ArchetypeChunk& chunk, u32 column) {
+            return getChangedVersions(chunk, column) + chunkCapacity;
+        }
+
+        // returns column of component in this archetype or -1 if archetype does not have such component
+        [[nodiscard]] inline s32 getColumn(component_id componentId) const {
+            return componentId < columns.size() ? columns[componentId] : -1;
+        }
+
+        [[nodiscard]] inline bool contains(component_id componentId) const {
+            return getColumn(componentId) >= 0;
+        }
+
+        // moves component of column from src into uninitialized dst, src is left destroyed
+        inline void relocate(u32 column, void* dst, void* src) {
+            if (relocateFunctions[column]) {
+                relocateFunctions[column](dst, (BaseComponent*) src);
+            } else {
+                memcpy(dst, src, sizes[column]);
+            }
+        }
+
+        // reserves a new row at the end of storage for entity, components memory is NOT initialized
+        void allocate(entity_id entityId, u32& chunk, u32& row);
+        // makes sure that next count rows are allocated without allocating chunks memory
+        void reserve(u32 count);
+        // removes row by moving last row into its place, components of removed row should be already destroyed or relocated
+        // returns entity id that was moved into the row or invalid_entity_id
+        entity_id deallocate(u32 chunk, u32 row);
+        void destroyComponents(u32 chunk, u32 row);
+        // destroys all components and releases all chunks
+        void clear();
+        // reorders rows, so that row i receives old row order[i], all columns and versions are moved together
+        void permute(const vector<u32>& order);
+        // copies all rows into empty target archetype with the same signature, chunk by chunk
+        // trivially copyable columns are copied with memcpy, other components with their copy constructor
+        // copied slots are stamped as added and changed with version
+        void copy(Archetype& target, component_version version);
+        // appends copy of all rows into target, which signature is a subset of this signature
+        // columns, which target doesn't have, are skipped
+        void copyRows(Archetype& target, component_version version);
+
+    private:
+        u8* allocateChunk();
+        void releaseChunk(u8* data);
+
+    private:
+        archetype_signature signature;
+        vector<component_size> sizes;
+        vector<component_size> offsets;
+        vector<component_size> versionOffsets;
+        vector<ComponentRelocateFunction> relocateFunctions;
+        u32 chunkCapacity = 0;
+        component_size chunkSize = 0;
+        vector<ArchetypeChunk> chunks;
+        // memory of released or reserved chunks, reused by allocate()
+        vector<u8*> freeChunks;
+        u32 entityCount = 0;
+        // sparse index: component id -> column, -1 for missing components
+        vector<s32> columns;
+        // cached transitions into other archetypes, when component is added or removed
+        // sparse arrays indexed by component id, nullptr when transition is not resolved yet
+        vector<Archetype*> addEdges;
+        vector<Archetype*> removeEdges;
+
+        friend class Registry;
+    };
+
+    // cached result of multi-component query: archetypes that have all query components and columns of those components
+    // Registry matches every new archetype against existing queries, so iterations never rediscover matching archetypes
+    // entities of matched archetype are already packed in its chunks, so query doesn't need to track them one by one
+    class ENGINE_API Query final {
+        IMMUTABLE(Query)
+    public:
+        explicit Query(const archetype_signature& components) : components(components) {}
+        ~Query() = default;
+
+    public:
+        // components in order of query template arguments
+        [[nodiscard]] inline const archetype_signature& getComponents() const {
+            return components;
+        }
+
+        [[nodiscard]] inline size_t getArchetypeCount() const {
+            return archetypes.size();
+        }
+
+        [[nodiscard]] inline Archetype* getArchetype(size_t index) const {
+            return archetypes[index];
+        }
+
+        // columns of query components in matched archetype
+        [[nodiscard]] inline const s32* getColumns(size_t index) const {
+            return &columns[index * components.size()];
+        }
+
+        [[nodiscard]] size_t getEntityCount() const;
+
+        // adds archetype into query, if it has all query components
+        void match(Archetype* archetype);
+        void clear();
+
+        static u32 nextId();
+
+    private:
+        archetype_signature components;
+        vector<Archetype*> archetypes;
+        vector<s32> columns;
+    };
+
+    // unique id of query with Components, used by Registry to find its cached Query
+    template<class... Components>
+    inline u32 query_id() {
+        static const u32 id = Query::nextId();
+        return id;
+    }
+
+    class Registry;
+
+    // size of single memory block for recorded components
+    constexpr component_size command_buffer_block_size = kb_16;
+
+    // records structural changes of registry to apply them later at sync point, e.g. while iterating components in parallel
+    // entities created by buffer get pending handles, which can be used only in commands of the same buffer
+    class ENGINE_API CommandBuffer final {
+        IMMUTABLE(CommandBuffer)
+    public:
+        CommandBuffer() = default;
+        ~CommandBuffer();
+
+    public:
+        entity_id createEntity();
+        void deleteEntity(entity_id entityId);
+        // adds or replaces component
+        template<class Component, typename... Args>
+        void addComponent(entity_id entityId, Args&&... componentArgs);
+        template<class Component>
+        void removeComponent(entity_id entityId);
+        // replaces component only if entity still has it at flush time
+        template<class Component, typename... Args>
+        void updateComponent(entity_id entityId, Args&&... componentArgs);
+
+        [[nodiscard]] inline bool empty() const {
+            return commands.empty();
+        }
+
+        // applies recorded commands in the same order and clears buffer
+        // commands of entities, that are already deleted, are skipped
+        void flush(Registry& registry);
+        void clear();
+
+    private:
+        enum CommandType : u8 {
+            CREATE_ENTITY, DELETE_ENTITY, ADD_COMPONENT, REMOVE_COMPONENT, UPDATE_COMPONENT
+        };
+
+        struct Command {
+            CommandType type;
+            component_id componentId = 0;
+            entity_id entityId = invalid_entity_id;
+            BaseComponent* component = nullptr;
+        };
+
+        // pending handle is [generation: 0][index: pending index + 1], so it never matches a registry handle
+        [[nodiscard]] static inline bool isPending(entity_id entityId) {
+            return entity_generation(entityId) == 0 && entityId != invalid_entity_id;
+        }
+
+        template<class Component, typename... Args>
+        void pushComponent(CommandType type, entity_id entityId, Args&&... componentArgs);
+        void* allocateComponent(component_size size);
+        void flushPending(Registry& registry);
+
+    private:
+        vector<Command> commands;
+        u32 pendingCount = 0;
+        // recorded components are placed into arena, which is reset after flush
+        ArenaAllocator components { command_buffer_block_size, heap_allocator(MemoryTag::ECS) };
+    };
+
+    // per-thread command buffers of registry, each thread records into its own buffer without locks
+    class ENGINE_API CommandBuffers final {
+        IMMUTABLE(CommandBuffers)
+    public:
+        CommandBuffers();
+        ~CommandBuffers() = default;
+
+    public:
+        // returns command buffer of calling thread
+        CommandBuffer& get();
+        // applies buffers in the order they were created, must be called when nobody records commands
+        void flush(Registry& registry);
+        void clear();
+
+    private:
+        std::mutex mutex;
+        std::unordered_map<std::thread::id, Scope<CommandBuffer>> threadBuffers;
+        vector<CommandBuffer*> buffers;
+        u64 id;
+    };
+
+    // callbacks of component type, see Registry::onAdded() and Registry::onRemoved()
+    struct ComponentHooks {
+        std::function<void(BaseComponent*)> added;
+        std::function<void(BaseComponent*)> removed;
+    };
+
     typedef void (*EntityFunction)(entity_id);
     // Registry of Components, Systems, Entities
     class ENGINE_API Registry {
@@ -153,25 +492,96 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
         entity_id createEntity();
         template<class Component, typename... Args>
         entity_id createEntity(Args&&... componentArgs);
+        // creates count entities with default constructed Components directly in their archetype, storage is reserved once
+        // function(index, Components*...) is called for each new entity to initialize its components
+        template<class... Components, typename Function>
+        vector<entity_id> createEntities(u32 count, const Function& function);
         void deleteEntity(entity_id& entityId);
+        // returns false for invalid handles and handles of deleted entities
+        [[nodiscard]] bool isAlive(entity_id entityId) const;
         // components
         template<class Component, typename... Args>
         bool addComponent(entity_id entityId, Args&&... componentArgs);
+        // adds or replaces components[i] of entities[i], storage of each target archetype is reserved once
+        template<class Component>
+        void addComponents(const entity_id* entities, const Component* components, size_t count);
+        template<class Component>
+        inline void addComponents(const vector<entity_id>& entities, const vector<Component>& components) {
+            ENGINE_ASSERT(entities.size() == components.size(), "addComponents() failed -> entities and components sizes are different!");
+            addComponents<Component>(entities.data(), components.data(), entities.size());
+        }
         template<class Component>
         bool removeComponent(entity_id entityId);
         template<class Component>
         Component* getComponent(entity_id entityId);
+        template<class Component>
+        bool hasComponent(entity_id entityId);
+        // replaces component in place or adds it, if entity doesn't have it yet
+        // returns true if component was replaced
+        template<class Component, typename... Args>
+        bool updateComponent(entity_id entityId, Args&&... componentArgs);
+        // stamps component with current version, for writes made through pointers returned by getComponent() or each()
+        template<class Component>
+        void markChanged(entity_id entityId);
+        // versions
+        // every add/update of component stamps its slot with current version
+        [[nodiscard]] inline component_version getVersion() const {
+            return version;
+        }
+        // returns current version and starts the next one
+        // writes made after this call are visited by eachChanged(returned version)
+        inline component_version nextVersion() {
+            return version++;
+        }
+        // visits components added or changed after sinceVersion
+        template<class Component, typename Function>
+        void eachChanged(component_version sinceVersion, const Function& function);
+        // visits components added after sinceVersion
+        template<class Component, typename Function>
+        void eachAdded(component_version sinceVersion, const Function& function);
+        // starts recording removals of Component, so they can be visited by eachRemoved()
+        template<class Component>
+        void trackRemoved();
+        // visits ids of entities, which Component was removed from (or which were deleted) after sinceVersion
+        template<class Component, typename Function>
+        void eachRemoved(component_version sinceVersion, const Function& function);
+        // forgets recorded removals up to untilVersion inclusive
+        template<class Component>
+        void clearRemoved(component_version untilVersion);
+        // hooks
+        // added hook is called when Component was constructed in registry storage and has its final value
+        // removed hook is called right before Component is destroyed by remove, replace, entity delete or clear()
+        // replacing component calls removed hook of old value, then added hook of new one
+        // hooks must not add or remove entities and components
+        template<class Component>
+        void onAdded(const std::function<void(Component*)>& hook);
+        template<class Component>
+        void onRemoved(const std::function<void(Component*)>& hook);
         // entity/component iterations
         template<typename Function>
         void eachEntity(const Function& function);
 
-        template<class Component, typename Function>
-        void each(const Function& function);
-        template<class Component1, class Component2, typename Function>
-        void each(const Function& function);
-        template<class Component1, class Component2, class Component3, typename Function>
+        // returns cached query of Components, it's created on the first call and kept up to date by registry
+        template<class... Components>
+        Query& query();
+
+        // iterates all entities that have every of Components, walking matching archetypes chunk by chunk
+        template<class... Components, typename Function>
         void each(const Function& function);
 
+        // same as each(), but rows of matching archetypes are split into groups of grain rows and processed by scheduler.parallelFor()
+        // calling thread processes groups too and returns when all of them are done, so it's safe to call it from worker thread
+        // function may only modify components passed into it, entities and components must not be added or removed
+        template<class... Components, typename Scheduler, typename Function>
+        void parallelEach(Scheduler& scheduler, u32 grain, const Function& function);
+
+        // reorders entities of each archetype that has Component, so that each() visits them in compare(const Component&, const Component&) order
+        // all components of entity share its row, so paired components follow the same order, entity handles stay valid
+        // insertion sort is used first, so already sorted or nearly sorted archetypes cost almost a single pass
+        // entities and components must not be added or removed during sort
+        template<class Component, typename Compare>
+        void sort(const Compare& compare);
+
         template<class Component, typename Function>
         void eachPair(const Function& function);
         template<class Component1, class Component2, typename Function>
@@ -187,30 +597,117 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
 
         void clear();
 
+        // snapshots
+        // replaces content of target with copy of all entities and components of this registry
+        // entity table is copied as is, so handles of this registry address the same entities in target
+        // handles that were stale in target stay stale, target hooks, queries and removals tracking are kept
+        void clone(Registry& target);
+        // same as clone(), but components of skipped types are not copied, their entities are copied anyway
+        // e.g. render snapshot doesn't need scripts and colliders
+        void clone(Registry& target, const archetype_signature& skipped);
+        // returns copy of this registry, see clone()
+        Scope<Registry> snapshot();
+        // replaces content with snapshot: handles created before snapshot are valid again, handles created after it are stale
+        inline void restore(Registry& snapshot) {
+            snapshot.clone(*this);
+        }
+
+        // command buffer of calling thread, see CommandBuffer
+        inline CommandBuffer& getCommandBuffer() {
+            return commandBuffers.get();
+        }
+        // applies commands recorded by all threads since last flush
+        inline void flushCommands() {
+            commandBuffers.flush(*this);
+        }
+
         template<class ByComponent>
         entity_id findEntity(const std::function<bool(ByComponent*)> &condition);
         template<class ByComponent, class ResultComponent>
         ResultComponent* findComponent(const std::function<bool(ByComponent*)> &condition);
 
     private:
-        static inline entity* toEntity(entity_id entityId) {
-            return (entity*) entityId;
+        inline entity* toEntity(entity_id entityId) {
+            ENGINE_ASSERT(isAlive(entityId), "toEntity() failed -> entity handle is invalid or stale!");
+            return &entities[entity_index(entityId)];
         }
 
-        static inline u32 toEntityIndex(entity_id entityId) {
-            return toEntity(entityId)->first;
+    private:
+        // creates entity in archetype, components memory is NOT initialized
+        entity_id createEntity(Archetype* archetype);
+        // returns memory for a new component of entity, old component is destroyed if entity already has it
+        void* addComponentData(entity_id entityId, component_id componentId);
+        bool removeComponent(entity_id entityId, component_id componentId);
+        // writes current version into added and/or changed versions of entity component slot
+        inline void stampChanged(entity* record, u32 column) {
+            record->archetype->getChangedVersions(record->archetype->chunks[record->chunk], column)[record->row] = version;
         }
-
-        static inline entity_data& toEntityData(entity_id entityId) {
-            return toEntity(entityId)->second;
+        inline void stampAdded(entity* record, u32 column) {
+            stampChanged(record, column);
+            record->archetype->getAddedVersions(record->archetype->chunks[record->chunk], column)[record->row] = version;
         }
+        void logRemoved(component_id componentId, entity_id entityId);
+        inline void notifyAdded(component_id componentId, BaseComponent* component) {
+            if (componentId < hooks.size() && hooks[componentId].added) {
+                hooks[componentId].added(component);
+            }
+        }
+        inline void notifyRemoved(component_id componentId, BaseComponent* component) {
+            if (componentId < hooks.size() && hooks[componentId].removed) {
+                hooks[componentId].removed(component);
+            }
+        }
+        inline bool hasAddedHook(component_id componentId) const {
+            return componentId < hooks.size() && hooks[componentId].added;
+        }
+        inline bool hasRemovedHook(component_id componentId) const {
+            return componentId < hooks.size() && hooks[componentId].removed;
+        }
+        ComponentHooks& getHooks(component_id componentId);
+        template<class Component>
+        inline Component* createDefault(entity* record, u32 column, entity_id entityId) {
+            auto* component = new(record->archetype->getComponentData(record->chunk, record->row, column)) Component();
+            component->entityId = entityId;
+            return component;
+        }
+        Query& getQuery(u32 queryId, const archetype_signature& components);
+        template<typename Function>
+        void eachVersion(component_id componentId, component_version sinceVersion, bool added, const Function& function);
+        Archetype* getArchetype(const archetype_signature& signature);
+        // reorders archetype rows and updates entity records of moved entities
+        void sortRows(Archetype* archetype, const vector<u32>& order);
+        Archetype* getAddArchetype(Archetype* archetype, component_id componentId);
+        Archetype* getRemoveArchetype(Archetype* archetype, component_id componentId);
+        // moves entity row into another archetype, relocating shared components and destroying the rest
+        void moveEntity(entity_id entityId, Archetype* archetype);
+
+        template<class... Components, typename Function, size_t... I>
+        static void eachRow(
+                Archetype* archetype, const ArchetypeChunk& chunk, const s32* columns,
+                u32 begin, u32 end,
+                const Function& function, std::index_sequence<I...>
+        );
 
     private:
-        void removeComponentInternal(component_id componentId, u32 componentIndex);
-
-    private:
-        std::unordered_map<component_id, component_data> components;
-        vector<entity*> entities;
+        std::map<archetype_signature, Scope<Archetype>> archetypes;
+        vector<Archetype*> archetypeList; // in creation order, for queries
+        vector<entity> entities; // entity table, indexed by entity_index()
+        u32 freeEntity = invalid_entity_index; // head of deleted records list
+        size_t aliveCount = 0;
+        CommandBuffers commandBuffers;
+        component_version version = 1;
+        // removals log, recorded only for tracked component types
+        struct RemovedComponents {
+            bool tracked = false;
+            vector<std::pair<entity_id, component_version>> entities;
+        };
+        vector<RemovedComponents> removedComponents; // indexed by component id
+        vector<ComponentHooks> hooks; // indexed by component id
+        // cached queries indexed by query_id(), guarded, because queries are created lazily from any iterating thread
+        vector<Scope<Query>> queries;
+        std::mutex queriesMutex;
+
+        friend class CommandBuffer;
     };
 
     template<class Component, typename... Args>
@@ -227,44 +724,72 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
         ENGINE_ASSERT(entityId != invalid_entity_id, "addComponent() failed -> invalid entity id!");
         ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
 
+        // component is constructed before moving entity, because args may refer into registry storage
         auto component = Component { std::forward<Args>(componentArgs)... };
-        component_id componentId = Component::ID;
-        auto createFunction = BaseComponent::getCreateFunction(componentId);
-
-        std::pair<component_id, u32> componentIdAndIndex;
-        componentIdAndIndex.first = componentId;
-        componentIdAndIndex.second = createFunction(
-                components[componentId],
-                entityId,
-                &component
-        );
-
-        auto& entityData = toEntityData(entityId);
-        entityData.emplace_back(componentIdAndIndex);
+        auto* newComponent = new(addComponentData(entityId, Component::ID)) Component(std::move(component));
+        newComponent->entityId = entityId;
+        notifyAdded(Component::ID, newComponent);
         return true;
     }
 
+    template<class... Components, typename Function>
+    vector<entity_id> Registry::createEntities(u32 count, const Function& function) {
+        ENGINE_ASSERT((BaseComponent::isValid<Components>() && ...), "BaseComponent::isValid failed -> invalid component id!");
+
+        archetype_signature signature = { Components::ID... };
+        std::sort(signature.begin(), signature.end());
+        ENGINE_ASSERT(std::adjacent_find(signature.begin(), signature.end()) == signature.end(), "createEntities() failed -> duplicated components!");
+        Archetype* archetype = getArchetype(signature);
+        const u32 columns[] = { (u32) archetype->getColumn(Components::ID)... };
+
+        vector<entity_id> newEntities;
+        newEntities.reserve(count);
+        entities.reserve(entities.size() + count);
+        archetype->reserve(count);
+        for (u32 i = 0 ; i < count ; i++) {
+            entity_id entityId = createEntity(archetype);
+            entity* record = toEntity(entityId);
+            for (u32 column : columns) {
+                stampAdded(record, column);
+            }
+            function(i, createDefault<Components>(record, archetype->getColumn(Components::ID), entityId)...);
+            if (!hooks.empty()) {
+                (notifyAdded(Components::ID, getComponent<Components>(entityId)), ...);
+            }
+            newEntities.emplace_back(entityId);
+        }
+        return newEntities;
+    }
+
     template<class Component>
-    bool Registry::removeComponent(entity_id entityId) {
-        ENGINE_ASSERT(entityId != invalid_entity_id, "addComponent() failed -> invalid entity id!");
+    void Registry::addComponents(const entity_id* entityIds, const Component* components, size_t count) {
         ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
 
-        component_id componentId = Component::ID;
-        auto& entityData = toEntityData(entityId);
-
-        for (u32 i = 0 ; i < entityData.size() ; i++) {
-            const auto& componentIdAndIndex = entityData[i];
-            if (componentId == componentIdAndIndex.first) {
-                removeComponentInternal(componentIdAndIndex.first, componentIdAndIndex.second);
-                u32 srcIndex = entityData.size() - 1;
-                u32 destIndex = i;
-                entityData[destIndex] = entityData[srcIndex];
-                entityData.pop_back();
-                return true;
+        // reserve rows of each target archetype before moving entities
+        unordered_map<Archetype*, u32> archetypeCounts;
+        for (size_t i = 0 ; i < count ; i++) {
+            Archetype* archetype = toEntity(entityIds[i])->archetype;
+            if (!archetype->contains(Component::ID)) {
+                archetypeCounts[getAddArchetype(archetype, Component::ID)]++;
             }
         }
+        for (const auto& archetypeCount : archetypeCounts) {
+            archetypeCount.first->reserve(archetypeCount.second);
+        }
+
+        for (size_t i = 0 ; i < count ; i++) {
+            auto* newComponent = new(addComponentData(entityIds[i], Component::ID)) Component(components[i]);
+            newComponent->entityId = entityIds[i];
+            notifyAdded(Component::ID, newComponent);
+        }
+    }
+
+    template<class Component>
+    bool Registry::removeComponent(entity_id entityId) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "removeComponent() failed -> invalid entity id!");
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
 
-        return false;
+        return removeComponent(entityId, Component::ID);
     }
 
     template<class Component>
@@ -272,73 +797,266 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
         ENGINE_ASSERT(entityId != invalid_entity_id, "getComponent() failed -> invalid entity id!");
         ENGINE_ASSERT(BaseComponent::isValid<Component>(), "getComponent failed -> invalid component id!");
 
-        auto& entityData = toEntityData(entityId);
-        component_id componentId = Component::ID;
+        entity* record = toEntity(entityId);
+        s32 column = record->archetype->getColumn(Component::ID);
+        if (column < 0) {
+            return nullptr;
+        }
+
+        return (Component*) record->archetype->getComponentData(record->chunk, record->row, column);
+    }
+
+    template<class Component>
+    bool Registry::hasComponent(entity_id entityId) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "hasComponent() failed -> invalid entity id!");
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "hasComponent failed -> invalid component id!");
+
+        return toEntity(entityId)->archetype->contains(Component::ID);
+    }
 
-        for (const auto& componentIdAndIndex : entityData) {
-            if (componentId == componentIdAndIndex.first) {
-                return (Component*) &components[componentId][componentIdAndIndex.second];
+    template<class Component, typename... Args>
+    bool Registry::updateComponent(entity_id entityId, Args&&... componentArgs) {
+        bool replaced = hasComponent<Component>(entityId);
+        addComponent<Component>(entityId, std::forward<Args>(componentArgs)...);
+        return replaced;
+    }
+
+    template<class Component>
+    void Registry::markChanged(entity_id entityId) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "markChanged() failed -> invalid entity id!");
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "markChanged failed -> invalid component id!");
+
+        entity* record = toEntity(entityId);
+        s32 column = record->archetype->getColumn(Component::ID);
+        if (column >= 0) {
+            stampChanged(record, column);
+        }
+    }
+
+    template<typename Function>
+    void Registry::eachVersion(component_id componentId, component_version sinceVersion, bool added, const Function& function) {
+        for (Archetype* archetype : archetypeList) {
+            s32 column = archetype->getColumn(componentId);
+            if (column < 0) continue;
+
+            for (const auto& chunk : archetype->chunks) {
+                component_version* versions = added
+                        ? archetype->getAddedVersions(chunk, column)
+                        : archetype->getChangedVersions(chunk, column);
+                u8* components = archetype->getColumnData(chunk, column);
+                for (u32 row = 0 ; row < chunk.size ; row++) {
+                    if (versions[row] > sinceVersion) {
+                        function(components + row * archetype->sizes[column]);
+                    }
+                }
             }
         }
+    }
 
-        return nullptr;
+    template<class Component, typename Function>
+    void Registry::eachChanged(component_version sinceVersion, const Function& function) {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "eachChanged failed -> invalid component id!");
+        eachVersion(Component::ID, sinceVersion, false, [&function](u8* component) {
+            function((Component*) component);
+        });
     }
 
-    template<typename Function>
-    void Registry::eachEntity(const Function& function) {
-        for (entity* entity : entities) {
-            function((entity_id) entity);
+    template<class Component, typename Function>
+    void Registry::eachAdded(component_version sinceVersion, const Function& function) {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "eachAdded failed -> invalid component id!");
+        eachVersion(Component::ID, sinceVersion, true, [&function](u8* component) {
+            function((Component*) component);
+        });
+    }
+
+    template<class Component>
+    void Registry::trackRemoved() {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "trackRemoved failed -> invalid component id!");
+        if (Component::ID >= removedComponents.size()) {
+            removedComponents.resize(Component::ID + 1);
         }
+        removedComponents[Component::ID].tracked = true;
     }
 
     template<class Component, typename Function>
-    void Registry::each(const Function& function) {
-        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
+    void Registry::eachRemoved(component_version sinceVersion, const Function& function) {
+        ENGINE_ASSERT(Component::ID < removedComponents.size() && removedComponents[Component::ID].tracked,
+                      "eachRemoved failed -> removals of component are not tracked!");
+        for (const auto& removed : removedComponents[Component::ID].entities) {
+            if (removed.second > sinceVersion) {
+                function(removed.first);
+            }
+        }
+    }
+
+    template<class Component>
+    void Registry::clearRemoved(component_version untilVersion) {
+        if (Component::ID >= removedComponents.size()) return;
+
+        auto& entities = removedComponents[Component::ID].entities;
+        // log is ordered by version
+        auto it = std::find_if(entities.begin(), entities.end(), [untilVersion](const std::pair<entity_id, component_version>& removed) {
+            return removed.second > untilVersion;
+        });
+        entities.erase(entities.begin(), it);
+    }
 
-        component_data& componentData = components[Component::ID];
-        for (u32 i = 0 ; i < componentData.size() ; i += Component::TYPE_SIZE) {
-            Component* component = (Component*) &componentData[i];
-            function(component);
+    template<class Component>
+    void Registry::onAdded(const std::function<void(Component*)>& hook) {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "onAdded failed -> invalid component id!");
+        getHooks(Component::ID).added = [hook](BaseComponent* component) {
+            hook((Component*) component);
+        };
+    }
+
+    template<class Component>
+    void Registry::onRemoved(const std::function<void(Component*)>& hook) {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "onRemoved failed -> invalid component id!");
+        getHooks(Component::ID).removed = [hook](BaseComponent* component) {
+            hook((Component*) component);
+        };
+    }
+
+    template<typename Function>
+    void Registry::eachEntity(const Function& function) {
+        // iterating by index, so entities can be deleted inside function
+        for (u32 i = 0 ; i < entities.size() ; i++) {
+            if (entities[i].archetype) {
+                function(make_entity_id(i, entities[i].generation));
+            }
         }
     }
 
-    template<class Component1, class Component2, typename Function>
+    template<class... Components, typename Function, size_t... I>
+    void Registry::eachRow(
+            Archetype* archetype, const ArchetypeChunk& chunk, const s32* columns,
+            u32 begin, u32 end,
+            const Function& function, std::index_sequence<I...>
+    ) {
+        std::tuple<Components*...> columnData { (Components*) archetype->getColumnData(chunk, columns[I])... };
+        for (u32 row = begin ; row < end ; row++) {
+            function((std::get<I>(columnData) + row)...);
+        }
+    }
+
+    template<class... Components>
+    Query& Registry::query() {
+        ENGINE_ASSERT((BaseComponent::isValid<Components>() && ...), "BaseComponent::isValid failed -> invalid component id!");
+        return getQuery(query_id<Components...>(), { Components::ID... });
+    }
+
+    template<class... Components, typename Function>
     void Registry::each(const Function& function) {
-        ENGINE_ASSERT(BaseComponent::isValid<Component1>(), "BaseComponent::isValid failed -> invalid Component1 id!");
-        ENGINE_ASSERT(BaseComponent::isValid<Component2>(), "BaseComponent::isValid failed -> invalid Component2 id!");
-
-        component_data& componentData1 = components[Component1::ID];
-        for (u32 i = 0 ; i < componentData1.size() ; i += Component1::TYPE_SIZE) {
-            Component1* component1 = (Component1*) &componentData1[i];
-            entity_id entityId1 = component1->entityId;
-            Component2* component2 = getComponent<Component2>(entityId1);
-            if (component2) {
-                function(component1, component2);
+        Query& query = this->query<Components...>();
+        for (size_t a = 0 ; a < query.getArchetypeCount() ; a++) {
+            Archetype* archetype = query.getArchetype(a);
+            const s32* columns = query.getColumns(a);
+            for (const auto& chunk : archetype->chunks) {
+                eachRow<Components...>(archetype, chunk, columns, 0, chunk.size, function, std::index_sequence_for<Components...>());
             }
         }
     }
 
-    template<class Component1, class Component2, class Component3, typename Function>
-    void Registry::each(const Function& function) {
-        ENGINE_ASSERT(BaseComponent::isValid<Component1>(), "BaseComponent::isValid failed -> invalid Component1 id!");
-        ENGINE_ASSERT(BaseComponent::isValid<Component2>(), "BaseComponent::isValid failed -> invalid Component2 id!");
-        ENGINE_ASSERT(BaseComponent::isValid<Component3>(), "BaseComponent::isValid failed -> invalid Component3 id!");
-
-        component_data& componentData1 = components[Component1::ID];
-        for (u32 i = 0 ; i < componentData1.size() ; i += Component1::TYPE_SIZE) {
-            Component1* component1 = (Component1*) &componentData1[i];
-            entity_id entityId1 = component1->entityId;
-            Component2* component2 = getComponent<Component2>(entityId1);
-            Component3* component3 = getComponent<Component3>(entityId1);
-            if (component2 && component3) {
-                function(component1, component2, component3);
+    // limit of insertion sort shifts per row, before falling back to std::stable_sort
+    constexpr u32 sort_max_shifts_per_row = 8;
+
+    template<class Component, typename Compare>
+    void Registry::sort(const Compare& compare) {
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "sort failed -> invalid component id!");
+
+        vector<Component*> components;
+        vector<u32> order;
+        Query& query = this->query<Component>();
+        for (size_t a = 0 ; a < query.getArchetypeCount() ; a++) {
+            Archetype* archetype = query.getArchetype(a);
+            u32 count = archetype->getEntityCount();
+            if (count < 2) continue;
+
+            u32 column = query.getColumns(a)[0];
+            components.clear();
+            for (const auto& chunk : archetype->chunks) {
+                auto* data = (Component*) archetype->getColumnData(chunk, column);
+                for (u32 row = 0 ; row < chunk.size ; row++) {
+                    components.emplace_back(data + row);
+                }
+            }
+            auto less = [&components, &compare](u32 a, u32 b) {
+                return compare(*components[a], *components[b]);
+            };
+
+            // sort row indices, so components are moved only once
+            order.resize(count);
+            for (u32 i = 0 ; i < count ; i++) {
+                order[i] = i;
+            }
+            size_t shifts = 0;
+            const size_t maxShifts = (size_t) count * sort_max_shifts_per_row;
+            for (u32 i = 1 ; i < count && shifts <= maxShifts ; i++) {
+                u32 row = order[i];
+                u32 j = i;
+                for (; j > 0 && less(row, order[j - 1]) ; j--) {
+                    order[j] = order[j - 1];
+                }
+                order[j] = row;
+                shifts += i - j;
+            }
+            if (shifts > maxShifts) {
+                std::stable_sort(order.begin(), order.end(), less);
+            } else if (shifts == 0) {
+                continue;
+            }
+            sortRows(archetype, order);
+        }
+    }
+
+    template<class... Components, typename Scheduler, typename Function>
+    void Registry::parallelEach(Scheduler& scheduler, u32 grain, const Function& function) {
+        ENGINE_ASSERT(grain > 0, "parallelEach() failed -> grain must be greater than 0!");
+
+        struct RowRange {
+            Archetype* archetype;
+            const s32* columns;
+            u32 chunk;
+            u32 begin;
+            u32 end;
+        };
+        vector<RowRange> ranges;
+
+        // split dense rows of each chunk into groups, group never crosses chunk boundary
+        Query& query = this->query<Components...>();
+        for (size_t a = 0 ; a < query.getArchetypeCount() ; a++) {
+            Archetype* archetype = query.getArchetype(a);
+            RowRange range { archetype, query.getColumns(a), 0, 0, 0 };
+            for (u32 c = 0 ; c < archetype->chunks.size() ; c++) {
+                u32 size = archetype->chunks[c].size;
+                range.chunk = c;
+                for (u32 begin = 0 ; begin < size ; begin += grain) {
+                    range.begin = begin;
+                    range.end = std::min(begin + grain, size);
+                    ranges.emplace_back(range);
+                }
             }
         }
+
+        scheduler.parallelFor(ranges.size(), 1, [&ranges, &function](auto args) {
+            const RowRange& range = ranges[args.index];
+            eachRow<Components...>(
+                    range.archetype, range.archetype->chunks[range.chunk], range.columns,
+                    range.begin, range.end,
+                    function, std::index_sequence_for<Components...>()
+            );
+        });
     }
 
     template<class Component>
     size_t Registry::component_count() {
-        return components[Component::ID].size() / Component::TYPE_SIZE;
+        size_t count = 0;
+        for (Archetype* archetype : archetypeList) {
+            if (archetype->contains(Component::ID)) {
+                count += archetype->getEntityCount();
+            }
+        }
+        return count;
     }
 
     template<class Component>
@@ -350,11 +1068,17 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
     entity_id Registry::findEntity(const std::function<bool(ByComponent*)> &condition) {
         ENGINE_ASSERT(BaseComponent::isValid<ByComponent>(), "BaseComponent::isValid failed -> invalid ByComponent id!");
 
-        component_data& componentData = components[ByComponent::ID];
-        for (u32 i = 0 ; i < componentData.size() ; i += ByComponent::TYPE_SIZE) {
-            ByComponent* actualComponent = (ByComponent*) &componentData[i];
-            if (condition(actualComponent)) {
-                return actualComponent->entityId;
+        for (Archetype* archetype : archetypeList) {
+            s32 column = archetype->getColumn(ByComponent::ID);
+            if (column < 0) continue;
+
+            for (const auto& chunk : archetype->chunks) {
+                auto* components = (ByComponent*) archetype->getColumnData(chunk, column);
+                for (u32 row = 0 ; row < chunk.size ; row++) {
+                    if (condition(&components[row])) {
+                        return components[row].entityId;
+                    }
+                }
             }
         }
 
@@ -363,29 +1087,44 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
 
     template<class ByComponent, class ResultComponent>
     ResultComponent *Registry::findComponent(const std::function<bool(ByComponent*)> &condition) {
-        ENGINE_ASSERT(BaseComponent::isValid<ByComponent>(), "BaseComponent::isValid failed -> invalid ByComponent id!");
         ENGINE_ASSERT(BaseComponent::isValid<ResultComponent>(), "BaseComponent::isValid failed -> invalid ResultComponent id!");
 
-        component_data& componentData = components[ByComponent::ID];
-        for (u32 i = 0 ; i < componentData.size() ; i += ByComponent::TYPE_SIZE) {
-            ByComponent* actualComponent = (ByComponent*) &componentData[i];
-            if (condition(actualComponent)) {
-                return getComponent<ResultComponent>(actualComponent->entityId);
-            }
+        entity_id entityId = findEntity<ByComponent>(condition);
+        if (entityId == invalid_entity_id) {
+            return nullptr;
         }
+
+        return getComponent<ResultComponent>(entityId);
     }
 
     template<class Component, typename Function>
     void Registry::eachPair(const Function &function) {
         ENGINE_ASSERT(BaseComponent::isValid<Component>(), "eachPair failed -> invalid Component id!");
 
-        u32 typeSize = Component::TYPE_SIZE;
-        component_data& componentData = components[Component::ID];
-        for (u32 i = 0; i < componentData.size(); i += typeSize) {
-            for (u32 j = i + typeSize; j < componentData.size(); j += typeSize) {
-                Component* component1 = (Component*) &componentData[i];
-                Component* component2 = (Component*) &componentData[j];
-                function(component1, component2);
+        // walks each unique pair, the second component always comes after the first one in storage order
+        for (size_t a1 = 0 ; a1 < archetypeList.size() ; a1++) {
+            Archetype* archetype1 = archetypeList[a1];
+            s32 column1 = archetype1->getColumn(Component::ID);
+            if (column1 < 0) continue;
+
+            for (size_t c1 = 0 ; c1 < archetype1->chunks.size() ; c1++) {
+                auto* components1 = (Component*) archetype1->getColumnData(archetype1->chunks[c1], column1);
+                for (u32 r1 = 0 ; r1 < archetype1->chunks[c1].size ; r1++) {
+
+                    for (size_t a2 = a1 ; a2 < archetypeList.size() ; a2++) {
+                        Archetype* archetype2 = archetypeList[a2];
+                        s32 column2 = archetype2->getColumn(Component::ID);
+                        if (column2 < 0) continue;
+
+                        for (size_t c2 = a2 == a1 ? c1 : 0 ; c2 < archetype2->chunks.size() ; c2++) {
+                            auto* components2 = (Component*) archetype2->getColumnData(archetype2->chunks[c2], column2);
+                            u32 r2 = a2 == a1 && c2 == c1 ? r1 + 1 : 0;
+                            for (; r2 < archetype2->chunks[c2].size ; r2++) {
+                                function(&components1[r1], &components2[r2]);
+                            }
+                        }
+                    }
+                }
             }
         }
     }
@@ -395,16 +1134,53 @@ struct component_type : engine::ecs::Component<component_type<template_type>>
         ENGINE_ASSERT(BaseComponent::isValid<Component1>(), "eachPair failed -> invalid Component1 id!");
         ENGINE_ASSERT(BaseComponent::isValid<Component2>(), "eachPair failed -> invalid Component2 id!");
 
-        u32 typeSize1 = Component1::TYPE_SIZE;
-        u32 typeSize2 = Component2::TYPE_SIZE;
-        component_data& componentData1 = components[Component1::ID];
-        component_data& componentData2 = components[Component2::ID];
-        for (u32 i = 0; i < componentData1.size(); i += typeSize1) {
-            for (u32 j = 0; j < componentData2.size(); j += typeSize2) {
-                Component1* component1 = (Component1*) &componentData1[i];
-                Component2* component2 = (Component2*) &componentData2[j];
-                function(component1, component2);
+        Query& query2 = query<Component2>();
+        each<Component1>([&function, &query2](Component1* component1) {
+            for (size_t a = 0 ; a < query2.getArchetypeCount() ; a++) {
+                Archetype* archetype = query2.getArchetype(a);
+                s32 column = query2.getColumns(a)[0];
+                for (const auto& chunk : archetype->chunks) {
+                    auto* components2 = (Component2*) archetype->getColumnData(chunk, column);
+                    for (u32 row = 0 ; row < chunk.size ; row++) {
+                        function(component1, &components2[row]);
+                    }
+                }
             }
-        }
+        });
+    }
+
+    template<class Component, typename... Args>
+    void CommandBuffer::pushComponent(CommandType type, entity_id entityId, Args&&... componentArgs) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "CommandBuffer failed -> invalid entity id!");
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
+
+        Command command;
+        command.type = type;
+        command.componentId = Component::ID;
+        command.entityId = entityId;
+        command.component = new(allocateComponent(sizeof(Component))) Component { std::forward<Args>(componentArgs)... };
+        commands.emplace_back(command);
+    }
+
+    template<class Component, typename... Args>
+    void CommandBuffer::addComponent(entity_id entityId, Args&&... componentArgs) {
+        pushComponent<Component>(ADD_COMPONENT, entityId, std::forward<Args>(componentArgs)...);
+    }
+
+    template<class Component>
+    void CommandBuffer::removeComponent(entity_id entityId) {
+        ENGINE_ASSERT(entityId != invalid_entity_id, "CommandBuffer::removeComponent() failed -> invalid entity id!");
+        ENGINE_ASSERT(BaseComponent::isValid<Component>(), "BaseComponent::isValid failed -> invalid component id!");
+
+        Command command;
+        command.type = REMOVE_COMPONENT;
+        command.componentId = Component::ID;
+        command.entityId = entityId;
+        commands.emplace_back(command);
+    }
+
+    template<class Component, typename... Args>
+    void CommandBuffer::updateComponent(entity_id entityId, Args&&... componentArgs) {
+        pushComponent<Component>(UPDATE_COMPONENT, entityId, std::forward<Args>(componentArgs)...);
     }
-}
\ No newline at end of file
+}
@@ -64,5 +64,15 @@ namespace engine::event {
 
         ENGINE_API static bool keyHold(KeyCode keyCode);
         ENGINE_API static bool mouseHold(MouseCode mouseCode);
+
+        // action is called through a copy, so it may register new actions into the same map
+        template<typename ActionMap, typename Code>
+        static void dispatch(const ActionMap& actions, Code code) {
+            auto it = actions.find(code);
+            if (it != actions.end()) {
+                auto action = it->second;
+                action.function(code);
+            }
+        }
     };
 }
\ No newline at end of file
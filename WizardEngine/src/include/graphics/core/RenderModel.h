@@ -71,12 +71,12 @@ namespace engine::graphics {
 
     template<typename T>
     bool VRenderModel::hasCapacity(const VertexDataComponent<T> &vertexDataComponent) const {
-        return vbo.hasCapacity(vertexDataComponent.vertexData.size);
+        return vbo.hasCapacity(vertexDataComponent.vertexData.size());
     }
 
     template<typename T>
     void VRenderModel::increaseCounts(const VertexDataComponent<T> &vertexDataComponent) {
-        vbo.increaseCount(vertexDataComponent.vertexData.size);
+        vbo.increaseCount(vertexDataComponent.vertexData.size());
     }
 
     template<typename T>
@@ -86,7 +86,7 @@ namespace engine::graphics {
             vertexDataComponent.updateStart(previousVertexCount);
             upload(vertexDataComponent);
         }
-        previousVertexCount += vertexDataComponent.vertexData.size;
+        previousVertexCount += vertexDataComponent.vertexData.size();
     }
 
     template<typename T>
@@ -0,0 +1,47 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <ecs/Scene.h>
+
+namespace engine::graphics {
+
+    using namespace core;
+    using namespace ecs;
+
+    // Double-buffered copy of scene for pipelined frames.
+    // Simulation extracts frame N+1 into back buffer, while render reads frame N from front buffer.
+    // Buffers are swapped at sync point, so render is never more than one frame behind simulation.
+    class ENGINE_API RenderSnapshot final {
+
+    public:
+        RenderSnapshot();
+
+    public:
+        // copies entities, render components, camera, skybox and HDR env of scene into back buffer
+        void extract(Scene& scene);
+        // components, which render never reads, are not copied, e.g. game logic components of application
+        template<class... Components>
+        inline void skip() {
+            (skipped.emplace_back(Components::ID), ...);
+        }
+        // publishes back buffer for render, call it only when neither extract() nor render are running
+        void swap();
+        // empties both buffers, so render skips frames until next extract()
+        void clear();
+
+        [[nodiscard]] inline const Ref<Scene>& getFront() const {
+            return buffers[front];
+        }
+
+    private:
+        Ref<Scene> buffers[2];
+        // scripts, colliders, tags and audio are skipped by default
+        archetype_signature skipped;
+        u8 front = 0;
+        bool extracted = false;
+    };
+
+}
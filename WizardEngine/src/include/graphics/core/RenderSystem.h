@@ -34,6 +34,10 @@ namespace engine::graphics {
 
     public:
         static void onUpdate();
+        // renders given scene instead of active scene, e.g. front buffer of RenderSnapshot
+        static void onUpdate(Scene& scene);
+        // called when registry was copied for render, so renderers may consume its update flags
+        static void onExtract(Registry& registry);
         static void onDestroy();
 
     public:
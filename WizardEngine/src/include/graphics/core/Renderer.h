@@ -71,6 +71,9 @@ namespace engine::graphics {
     public:
         // implement this for draw algorithm
         virtual void render(ecs::Registry& registry) = 0;
+        // called when registry was copied into RenderSnapshot, the copy carries update flags to render
+        // override this to clear update flags of source registry, so geometry is uploaded once
+        virtual void onExtract(ecs::Registry& registry) {}
         // call this function when you are ready to release data from GPU
         void release();
 
@@ -127,6 +130,7 @@ namespace engine::graphics {
 
     public:
         void render(ecs::Registry& registry) override;
+        void onExtract(ecs::Registry& registry) override;
     private:
         void renderV(ecs::Registry &registry);
         void renderVI(ecs::Registry &registry);
@@ -145,6 +149,7 @@ namespace engine::graphics {
 
     public:
         void render(ecs::Registry &registry) override;
+        void onExtract(ecs::Registry& registry) override;
 
     private:
         void renderV(ecs::Registry &registry);
@@ -291,6 +296,23 @@ namespace engine::graphics {
         }
     }
 
+    template<typename Vertex>
+    void BatchRenderer<Vertex>::onExtract(ecs::Registry& registry) {
+        typedef VertexDataComponent<BatchVertex<Vertex>> Geometry;
+        typedef BaseMeshComponent<BatchVertex<Vertex>> Mesh;
+
+        if (!registry.empty_components<Geometry>()) {
+            registry.each<Geometry>([](Geometry* geometry) {
+                geometry->isUpdated = false;
+            });
+        }
+        if (!registry.empty_components<Mesh>()) {
+            registry.each<Mesh>([](Mesh* mesh) {
+                mesh->isUpdated = false;
+            });
+        }
+    }
+
     template<typename Vertex>
     void InstanceRenderer<Vertex>::renderV(ecs::Registry& registry) {
         typedef VertexDataComponent<InstanceVertex<Vertex>> Geometry;
@@ -388,6 +410,23 @@ namespace engine::graphics {
         }
     }
 
+    template<typename Vertex>
+    void InstanceRenderer<Vertex>::onExtract(ecs::Registry& registry) {
+        typedef VertexDataComponent<InstanceVertex<Vertex>> Geometry;
+        typedef BaseMeshComponent<InstanceVertex<Vertex>> Mesh;
+
+        if (!registry.empty_components<Geometry>()) {
+            registry.each<Geometry>([](Geometry* geometry) {
+                geometry->isUpdated = false;
+            });
+        }
+        if (!registry.empty_components<Mesh>()) {
+            registry.each<Mesh>([](Mesh* mesh) {
+                mesh->isUpdated = false;
+            });
+        }
+    }
+
     template<typename Vertex>
     void VRenderer<Vertex>::render(const ecs::Entity &entity) {
         VertexDataComponent<Vertex>* vertexDataComponent = entity.get<VertexDataComponent<Vertex>>();
@@ -400,7 +439,7 @@ namespace engine::graphics {
         uploadTransform<Transform3dComponent>(entity);
 
         vRenderModel.vao.bind();
-        drawV(vertexDataComponent->drawType, vertexDataComponent->vertexData.size);
+        drawV(vertexDataComponent->drawType, vertexDataComponent->vertexData.size());
         shaderProgram.stop();
     }
 
@@ -416,7 +455,7 @@ namespace engine::graphics {
         uploadTransform<Transform3dComponent>(entity);
 
         vRenderModel.vao.bind();
-        drawV(vertexDataComponent->drawType, vertexDataComponent->vertexData.size);
+        drawV(vertexDataComponent->drawType, vertexDataComponent->vertexData.size());
         shaderProgram.stop();
     }
 
@@ -429,7 +468,7 @@ namespace engine::graphics {
         upload(vertexDataComponent);
 
         vRenderModel.vao.bind();
-        drawV(vertexDataComponent.drawType, vertexDataComponent.vertexData.size);
+        drawV(vertexDataComponent.drawType, vertexDataComponent.vertexData.size());
         shaderProgram.stop();
     }
 
@@ -444,14 +483,14 @@ namespace engine::graphics {
         TextureBuffer::bind(textureId, TextureType::TEXTURE_2D);
 
         vRenderModel.vao.bind();
-        drawV(vertexDataComponent.drawType, vertexDataComponent.vertexData.size);
+        drawV(vertexDataComponent.drawType, vertexDataComponent.vertexData.size());
         shaderProgram.stop();
     }
 
     template<typename Vertex>
     void VRenderer<Vertex>::validate(const VertexDataComponent<Vertex>& vertexDataComponent) {
         if (!vRenderModel.hasCapacity(vertexDataComponent)) {
-            vRenderModel = { 0, vertexDataComponent.vertexData.size };
+            vRenderModel = { 0, vertexDataComponent.vertexData.size() };
             vRenderModel.vao.bind();
             vRenderModel.vbo.setFormat(shaderProgram.getVertexFormat());
             VertexArray::unbind();
@@ -563,7 +602,7 @@ namespace engine::graphics {
 
     template<typename T>
     void Renderer::createRenderModel(VertexDataComponent<T> &vertexDataComponent) {
-        createRenderModel(vertexDataComponent.vertexData.size);
+        createRenderModel(vertexDataComponent.vertexData.size());
     }
 
     template<typename T>
@@ -575,7 +614,7 @@ namespace engine::graphics {
     VRenderModel& Renderer::createRenderModel(const vector<VertexDataComponent<T>> &vertexDataComponents) {
         u32 vertexCount = 0;
         for (const auto& vertexDataComponent : vertexDataComponents) {
-            vertexCount += vertexDataComponent.vertexData.size;
+            vertexCount += vertexDataComponent.vertexData.size();
         }
         return createRenderModel(vertexCount);
     }
@@ -613,7 +652,7 @@ namespace engine::graphics {
             u32 vertexCount = 0;
             for (Object<T>& object : objects) {
                 VertexDataComponent<T>* geometry = object.get<VertexDataComponent<T>>();
-                vertexCount += geometry->vertexData.size;
+                vertexCount += geometry->vertexData.size();
             }
             VRenderModel& renderModel = createRenderModel(vertexCount);
             for (Object<T>& object : objects) {
@@ -625,12 +664,10 @@ namespace engine::graphics {
         u32 k = objects.size() / instancesPerDraw;
 
         for (u32 i = 0; i < k; i++) {
-            vector<VertexDataComponent<T>> geometries;
             u32 vertexCount = 0;
             for (u32 j = 0; j < instancesPerDraw; j++) {
                 u32 objectIndex = i * instancesPerDraw + j;
                 VertexDataComponent<T>* geometry = objects.at(objectIndex).get<VertexDataComponent<T>>();
-                geometries.emplace_back(*geometry);
                 vertexCount += geometry->vertexData.size();
             }
 
@@ -666,13 +703,11 @@ namespace engine::graphics {
         u32 k = objects.size() / instancesPerDraw;
 
         for (u32 i = 0; i < k; i++) {
-            vector<BaseMeshComponent<T>> meshes;
             u32 vertexCount = 0;
             u32 indexCount = 0;
             for (u32 j = 0; j < instancesPerDraw; j++) {
                 u32 objectIndex = i * instancesPerDraw + j;
                 BaseMeshComponent<T>* mesh = objects.at(objectIndex).get<BaseMeshComponent<T>>();
-                meshes.emplace_back(*mesh);
                 vertexCount += mesh->totalVertexCount();
                 indexCount += mesh->totalIndexCount();
             }
@@ -690,7 +725,7 @@ namespace engine::graphics {
     void Renderer::createVRenderModelInstanced(Object<T> &object, const vector<Object<T>> &objects) {
         VertexDataComponent<T>* geometry = object.get<VertexDataComponent<T>>();
         if (geometry) {
-            VRenderModel& renderModel = createRenderModel(geometry->vertexData.size);
+            VRenderModel& renderModel = createRenderModel(geometry->vertexData.size());
             renderModel.geometry = object.getId();
             for (const Object<T>& obj : objects) {
                 renderModel.entities.emplace_back(obj.getId());
@@ -6,6 +6,7 @@
 
 #include <graphics/core/Renderer.h>
 #include <platform/graphics/FrameBuffer.h>
+#include <core/frame_allocator.h>
 
 namespace engine::graphics {
 
@@ -17,7 +18,7 @@ namespace engine::graphics {
 
     public:
         void release();
-        u32 render(const vector<u32>& textures);
+        u32 render(const frame_vector<u32>& textures);
 
     private:
         Ref<FrameBuffer> frameBuffer;
@@ -8,5 +8,5 @@
 
 namespace engine::graphics {
     using namespace core;
-    typedef array<u32> IndexData;
+    typedef shared_array<u32> IndexData;
 }
\ No newline at end of file
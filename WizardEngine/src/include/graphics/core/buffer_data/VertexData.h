@@ -6,6 +6,7 @@
 
 #include <platform/graphics/RenderCommands.h>
 #include <ecs/ecs.h>
+#include <core/array.h>
 
 #include <algorithm>
 #include <functional>
@@ -16,6 +17,11 @@ namespace engine::graphics {
 
     using namespace core;
 
+    // vertices, indices and other geometry data of CPU side
+    inline Allocator& graphics_allocator() {
+        return heap_allocator(MemoryTag::GRAPHICS);
+    }
+
     template<typename V>
     struct BatchVertex {
         V vertex;
@@ -28,12 +34,13 @@ namespace engine::graphics {
     };
 
     template_component(VertexDataComponent, T) {
-        array<T> vertexData;
+        shared_array<T> vertexData;
         bool isUpdated = true;
         u8 renderModelId = 0;
         u32 drawType = DrawType::QUAD;
 
-        VertexDataComponent<T> copy();
+        // shares vertices with this component, until one of them is changed
+        VertexDataComponent<T> copy() const;
 
         void setBatchId(u32 batchId);
 
@@ -41,24 +48,21 @@ namespace engine::graphics {
 
         void invalidate();
 
-        template<typename TO>
-        VertexDataComponent<TO> toVertexDataComponent(const std::function<TO(const T&)>& vertexMapper);
+        template<typename Mapper, typename TO = std::decay_t<std::invoke_result_t<Mapper, const T&>>>
+        VertexDataComponent<TO> toVertexDataComponent(const Mapper& vertexMapper) const;
     };
 
     template<typename T>
-    VertexDataComponent<T> VertexDataComponent<T>::copy() {
-        VertexDataComponent<T> copyVertexDataComponent;
-        copyVertexDataComponent.drawType = drawType;
-        copyVertexDataComponent.renderModelId = renderModelId;
-        copyVertexDataComponent.isUpdated = isUpdated;
-        copyVertexDataComponent.vertexData = vertexData.copy();
-        return copyVertexDataComponent;
+    VertexDataComponent<T> VertexDataComponent<T>::copy() const {
+        return *this;
     }
 
     template<typename T>
     void VertexDataComponent<T>::setBatchId(u32 batchId) {
-        for (auto i = 0; i < vertexData.size; i++) {
-            vertexData.values[i].id = (float) batchId;
+        if (vertexData.empty() || vertexData[0].id == (float) batchId) return;
+
+        for (auto& vertex : vertexData.edit()) {
+            vertex.id = (float) batchId;
         }
     }
 
@@ -73,10 +77,12 @@ namespace engine::graphics {
     }
 
     template<typename T>
-    template<typename TO>
-    VertexDataComponent<TO>
-    VertexDataComponent<T>::toVertexDataComponent(const std::function<TO(const T &)>& vertexMapper) {
-        return VertexDataComponent<TO>{ vertexData.toVertexData(vertexMapper) };
+    template<typename Mapper, typename TO>
+    VertexDataComponent<TO> VertexDataComponent<T>::toVertexDataComponent(const Mapper& vertexMapper) const {
+        VertexDataComponent<TO> vertexDataComponent;
+        vertexDataComponent.vertexData = vertexData.map(vertexMapper);
+        vertexDataComponent.drawType = drawType;
+        return vertexDataComponent;
     }
 }
 
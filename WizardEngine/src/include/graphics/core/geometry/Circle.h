@@ -19,26 +19,24 @@ namespace engine::graphics {
 
     struct InstanceCircle : VertexDataComponent<InstanceVertex<CircleVertex>> {
         InstanceCircle() : VertexDataComponent<InstanceVertex<CircleVertex>>() {
-            auto vertices = new InstanceVertex<CircleVertex>[4] {
+            vertexData = array<InstanceVertex<CircleVertex>>({
                     InstanceVertex<CircleVertex> { CircleVertex { { -0.5, -0.5, 0.5 } } },
                     InstanceVertex<CircleVertex> { CircleVertex { { 0.5, -0.5, 0.5 } } },
                     InstanceVertex<CircleVertex> { CircleVertex { { 0.5, 0.5, 0.5 } } },
                     InstanceVertex<CircleVertex> { CircleVertex { { -0.5, 0.5, 0.5 } } },
-            };
-            vertexData = array<InstanceVertex<CircleVertex>> { vertices, 0, 4 };
+            }, graphics_allocator());
             this->drawType = DrawType::QUAD;
         }
     };
 
     struct BatchCircle : VertexDataComponent<BatchVertex<CircleVertex>> {
         BatchCircle() : VertexDataComponent<BatchVertex<CircleVertex>>() {
-            auto vertices = new BatchVertex<CircleVertex>[4] {
+            vertexData = array<BatchVertex<CircleVertex>>({
                     BatchVertex<CircleVertex> { CircleVertex { { -0.5, -0.5, 0.5 } } },
                     BatchVertex<CircleVertex> { CircleVertex { { 0.5, -0.5, 0.5 } } },
                     BatchVertex<CircleVertex> { CircleVertex { { 0.5, 0.5, 0.5 } } },
                     BatchVertex<CircleVertex> { CircleVertex { { -0.5, 0.5, 0.5 } } },
-            };
-            vertexData = array<BatchVertex<CircleVertex>> { vertices, 0, 4 };
+            }, graphics_allocator());
             this->drawType = DrawType::QUAD;
         }
     };
@@ -16,7 +16,7 @@ namespace engine::graphics {
         }
 
         void init() {
-            auto vertices = new T[36] {
+            this->vertexData = array<T>({
                     {{{-1.0f,  1.0f, -1.0f}}},
                     {{{-1.0f, -1.0f, -1.0f}}},
                     {{{1.0f, -1.0f, -1.0f}}},
@@ -53,9 +53,7 @@ namespace engine::graphics {
                     {{{1.0f, -1.0f, -1.0f}}},
                     {{{-1.0f, -1.0f,  1.0f}}},
                     {{{1.0f, -1.0f,  1.0f}}},
-            };
-
-            this->vertexData = { vertices, 0, 36 };
+            }, graphics_allocator());
             this->drawType = DrawType::TRIANGLE;
         }
     };
@@ -21,7 +21,7 @@ namespace engine::graphics {
     struct InstanceLine : VertexDataComponent<InstanceVertex<LineVertex>> {
         InstanceLine(const std::vector<LineVertex>& linesVertices)
         : VertexDataComponent<InstanceVertex<LineVertex>>() {
-            vertexData = toVertexData<LineVertex, InstanceVertex<LineVertex>>(linesVertices);
+            vertexData = toVertexData<LineVertex, InstanceVertex<LineVertex>>(linesVertices, graphics_allocator());
             this->drawType = DrawType::LINE;
         }
     };
@@ -29,7 +29,7 @@ namespace engine::graphics {
     struct BatchLine : VertexDataComponent<BatchVertex<LineVertex>> {
         BatchLine(const std::vector<LineVertex>& linesVertices)
         : VertexDataComponent<BatchVertex<LineVertex>>() {
-            vertexData = toVertexData<LineVertex, BatchVertex<LineVertex>>(linesVertices);
+            vertexData = toVertexData<LineVertex, BatchVertex<LineVertex>>(linesVertices, graphics_allocator());
             this->drawType = DrawType::LINE;
         }
     };
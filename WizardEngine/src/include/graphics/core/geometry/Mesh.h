@@ -21,32 +21,27 @@ namespace engine::graphics {
 
     template<typename T>
     struct BaseMesh {
-        array<T> vertexData;
+        shared_array<T> vertexData;
         IndexData indexData;
 
-        BaseMesh<T> copy();
+        // shares vertices and indices with this mesh, until one of them is changed
+        BaseMesh<T> copy() const;
 
-        template<typename TO>
-        BaseMesh<TO> toMesh(const std::function<TO(const T&)>& vertexMapper);
+        template<typename Mapper, typename TO = std::decay_t<std::invoke_result_t<Mapper, const T&>>>
+        BaseMesh<TO> toMesh(const Mapper& vertexMapper) const;
     };
 
     template<typename T>
-    BaseMesh<T> BaseMesh<T>::copy() {
-        return BaseMesh<T>{ vertexData.copy(), indexData.copy() };
+    BaseMesh<T> BaseMesh<T>::copy() const {
+        return *this;
     }
 
     template<typename T>
-    template<typename TO>
-    BaseMesh<TO> BaseMesh<T>::toMesh(const std::function<TO(const T &)> &vertexMapper) {
-        auto toVertexData = array<TO> {
-                new TO[vertexData.size],
-                vertexData.offset,
-                vertexData.size
-        };
-        for (auto j = 0; j < vertexData.size; j++) {
-            toVertexData.values[j] = vertexMapper(vertexData.values[j]);
-        }
-        return { toVertexData, indexData };
+    template<typename Mapper, typename TO>
+    BaseMesh<TO> BaseMesh<T>::toMesh(const Mapper& vertexMapper) const {
+        BaseMesh<TO> mesh { vertexData.map(vertexMapper), indexData };
+        mesh.vertexData.offset = vertexData.offset;
+        return mesh;
     }
 
     template_component(BaseMeshComponent, T) {
@@ -58,13 +53,14 @@ namespace engine::graphics {
 
         BaseMeshComponent() = default;
         BaseMeshComponent(const BaseMesh<T>& mesh) : mesh(mesh) {}
+        BaseMeshComponent(BaseMesh<T>&& mesh) : mesh(std::move(mesh)) {}
 
         [[nodiscard]] u32 getId() const {
-            return mesh.vertexData.values[0].id;
+            return mesh.vertexData[0].id;
         }
 
-        template<typename TO>
-        BaseMeshComponent<TO> toMeshComponent(const std::function<TO(const T&)>& vertexMapper);
+        template<typename Mapper, typename TO = std::decay_t<std::invoke_result_t<Mapper, const T&>>>
+        BaseMeshComponent<TO> toMeshComponent(const Mapper& vertexMapper) const;
 
         void setId(u32 id);
 
@@ -72,15 +68,15 @@ namespace engine::graphics {
 
         void invalidateMeshes(u32 prevVertexCount, u32 prevIndexCount);
 
-        [[nodiscard]] inline u32 totalVertexCount() const { return mesh.vertexData.size; }
-        [[nodiscard]] inline u32 totalIndexCount() const { return mesh.indexData.size; }
+        [[nodiscard]] inline u32 totalVertexCount() const { return mesh.vertexData.size(); }
+        [[nodiscard]] inline u32 totalIndexCount() const { return mesh.indexData.size(); }
     };
 
     template<typename T>
-    template<typename TO>
-    BaseMeshComponent<TO> BaseMeshComponent<T>::toMeshComponent(const std::function<TO(const T&)> &vertexMapper) {
+    template<typename Mapper, typename TO>
+    BaseMeshComponent<TO> BaseMeshComponent<T>::toMeshComponent(const Mapper& vertexMapper) const {
         BaseMeshComponent<TO> meshComponent;
-        meshComponent.mesh = mesh.template toMesh<TO>(vertexMapper);
+        meshComponent.mesh = mesh.toMesh(vertexMapper);
         meshComponent.vertexStart = vertexStart;
         meshComponent.indexStart = indexStart;
         meshComponent.isUpdated = isUpdated;
@@ -92,9 +88,7 @@ namespace engine::graphics {
         u32 meshInstanceId = getId();
         if (meshInstanceId == id) return;
 
-        const auto& vertexData = mesh.vertexData;
-        for (auto j = 0; j < vertexData.size; j++) {
-            auto& vertex = vertexData.values[j];
+        for (auto& vertex : mesh.vertexData.edit()) {
             vertex.id = (float) id;
         }
     }
@@ -106,7 +100,7 @@ namespace engine::graphics {
         copyMeshComponent.drawType = drawType;
         copyMeshComponent.indexStart = indexStart;
         copyMeshComponent.vertexStart = vertexStart;
-        copyMeshComponent.meshes = mesh.copy();
+        copyMeshComponent.mesh = mesh.copy();
         return copyMeshComponent;
     }
 
@@ -115,14 +109,14 @@ namespace engine::graphics {
         vertexStart = prevVertexCount;
         indexStart = prevIndexCount;
 
-        array<T>& vertexData = mesh.vertexData;
+        shared_array<T>& vertexData = mesh.vertexData;
         IndexData& indexData = mesh.indexData;
 
         vertexData.offset = vertexStart;
         indexData.offset = indexStart;
 
-        for (auto j = 0 ; j < indexData.size ; j++) {
-            auto& index = indexData.values[j];
+        // shared indices are copied first, so cached model meshes keep their original indices
+        for (auto& index : indexData.edit()) {
             index += vertexData.offset;
         }
     }
@@ -15,7 +15,7 @@ namespace engine::graphics {
 
     struct Points : VertexDataComponent<PointVertex> {
         Points(PointVertex* points, const uint32_t& count) : VertexDataComponent<PointVertex>() {
-            vertexData = { points, 0, count };
+            vertexData = array<PointVertex>(points, count, graphics_allocator());
             this->drawType = DrawType::POINTS;
         }
     };
@@ -17,26 +17,24 @@ namespace engine::graphics {
 
     struct InstanceQuad : VertexDataComponent<InstanceVertex<QuadVertex>> {
         InstanceQuad() : VertexDataComponent<InstanceVertex<QuadVertex>>() {
-            auto vertices = new InstanceVertex<QuadVertex>[4] {
+            vertexData = array<InstanceVertex<QuadVertex>>({
                     InstanceVertex<QuadVertex> { QuadVertex { { -0.5, -0.5, 0.5 } } },
                     InstanceVertex<QuadVertex> { QuadVertex { { 0.5, -0.5, 0.5 } } },
                     InstanceVertex<QuadVertex> { QuadVertex { { 0.5, 0.5, 0.5 } } },
                     InstanceVertex<QuadVertex> { QuadVertex { { -0.5, 0.5, 0.5 } } },
-            };
-            vertexData = array<InstanceVertex<QuadVertex>> { vertices, 0, 4 };
+            }, graphics_allocator());
             this->drawType = DrawType::QUAD;
         }
     };
 
     struct BatchQuad : VertexDataComponent<BatchVertex<QuadVertex>> {
         BatchQuad() : VertexDataComponent<BatchVertex<QuadVertex>>() {
-            auto vertices = new BatchVertex<QuadVertex>[4] {
+            vertexData = array<BatchVertex<QuadVertex>>({
                     BatchVertex<QuadVertex> { QuadVertex { { -0.5, -0.5, 0.5 } } },
                     BatchVertex<QuadVertex> { QuadVertex { { 0.5, -0.5, 0.5 } } },
                     BatchVertex<QuadVertex> { QuadVertex { { 0.5, 0.5, 0.5 } } },
                     BatchVertex<QuadVertex> { QuadVertex { { -0.5, 0.5, 0.5 } } },
-            };
-            vertexData = array<BatchVertex<QuadVertex>> { vertices, 0, 4 };
+            }, graphics_allocator());
             this->drawType = DrawType::QUAD;
         }
     };
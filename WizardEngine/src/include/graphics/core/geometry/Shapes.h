@@ -18,69 +18,42 @@ namespace engine::graphics {
         static BaseMeshComponent<T> newCube();
 
     private:
-        static T *newTriangleVertices();
-        static uint32_t *newTriangleIndices();
+        static array<T> newTriangleVertices();
+        static array<u32> newTriangleIndices();
 
-        static T *newSquareVertices();
-        static uint32_t *newSquareIndices();
+        static array<T> newSquareVertices();
+        static array<u32> newSquareIndices();
 
-        static T *newCubeVertices();
-        static uint32_t *newCubeIndices();
+        static array<T> newCubeVertices();
+        static array<u32> newCubeIndices();
     };
 
     template<typename T>
     BaseMeshComponent<T> Shapes<T>::newTriangle() {
-        BaseMesh<T>* meshes = new BaseMesh<T> {
-                array<T> {
-                        newTriangleVertices(),
-                        0,
-                        3
-                },
-                IndexData {
-                        newTriangleIndices(),
-                        0,
-                        3
-                }
-        };
-        return { meshes };
+        return BaseMesh<T> {
+                newTriangleVertices(),
+                newTriangleIndices()
+        };
     }
 
     template<typename T>
     BaseMeshComponent<T> Shapes<T>::newSquare() {
-        BaseMesh<T>* meshes = new BaseMesh<T> {
-                array<T> {
-                        newSquareVertices(),
-                        0,
-                        4
-                },
-                IndexData {
-                        newSquareIndices(),
-                        0,
-                        6
-                }
-        };
-        return { meshes };
+        return BaseMesh<T> {
+                newSquareVertices(),
+                newSquareIndices()
+        };
     }
 
     template<typename T>
     BaseMeshComponent<T> Shapes<T>::newCube() {
-        BaseMesh<T>* meshes = new BaseMesh<T> {
-                array<T> {
-                        newCubeVertices(),
-                        0,
-                        24
-                },
-                IndexData {
-                        newCubeIndices(),
-                        0,
-                        36
-                }
-        };
-        return { meshes };
+        return BaseMesh<T> {
+                newCubeVertices(),
+                newCubeIndices()
+        };
     }
 
     template<typename T>
-    T *Shapes<T>::newTriangleVertices() {
+    array<T> Shapes<T>::newTriangleVertices() {
         auto v1 = T {
                 {-0.5f, -0.5f, 0.0f }
         };
@@ -93,18 +66,18 @@ namespace engine::graphics {
                 {0.0f,  0.5f, 0.0f }
         };
 
-        return new T[] {
+        return array<T>({
                 v1, v2, v3
-        };
+        }, graphics_allocator());
     }
 
     template<typename T>
-    uint32_t *Shapes<T>::newTriangleIndices() {
-        return new uint32_t[] {0, 1, 2};
+    array<u32> Shapes<T>::newTriangleIndices() {
+        return array<u32>({0, 1, 2}, graphics_allocator());
     }
 
     template<typename T>
-    T *Shapes<T>::newSquareVertices() {
+    array<T> Shapes<T>::newSquareVertices() {
         auto v1 = T {
                 { -1, -1, 0 }
         };
@@ -121,21 +94,21 @@ namespace engine::graphics {
                 { 1, -1, 0 }
         };
 
-        return new T[] {
+        return array<T>({
                 v1, v2, v3, v4
-        };
+        }, graphics_allocator());
     }
 
     template<typename T>
-    uint32_t *Shapes<T>::newSquareIndices() {
-        return new uint32_t[] {
+    array<u32> Shapes<T>::newSquareIndices() {
+        return array<u32>({
                 0, 2, 1,
                 0, 3, 2
-        };
+        }, graphics_allocator());
     }
 
     template<typename T>
-    T *Shapes<T>::newCubeVertices() {
+    array<T> Shapes<T>::newCubeVertices() {
         auto v1 = T {
                 {-0.5f,0.5f,-0.5f},
                 {0,0,},
@@ -280,19 +253,19 @@ namespace engine::graphics {
                 {0.5f,-0.5f,0.5f},
         };
 
-        return new T[] {
+        return array<T>({
                 v1, v2, v3, v4,
                 v5, v6, v7, v8,
                 v9, v10, v11, v12,
                 v13, v14, v15, v16,
                 v17, v18, v19, v20,
                 v21, v22, v23, v24,
-        };
+        }, graphics_allocator());
     }
 
     template<typename T>
-    uint32_t *Shapes<T>::newCubeIndices() {
-        return new uint32_t [] {
+    array<u32> Shapes<T>::newCubeIndices() {
+        return array<u32>({
                 0,1,3,
                 3,1,2,
                 4,5,7,
@@ -305,6 +278,6 @@ namespace engine::graphics {
                 19,17,18,
                 20,21,23,
                 23,21,22
-        };
+        }, graphics_allocator());
     }
 }
@@ -5,7 +5,7 @@
 #pragma once
 
 #include <core/filesystem.h>
-#include <core/Mappers.h>
+#include <core/map.h>
 
 #include <graphics/core/geometry/Mesh.h>
 #include <graphics/materials/Material.h>
@@ -88,7 +88,7 @@ namespace engine::io {
     template<typename T>
     class ModelFile final {
 
-        typedef std::unordered_map<std::string, Model> ModelMap;
+        typedef core::unordered_map<std::string, Model> ModelMap;
 
     public:
         static Model read(const std::string &filepath, const std::string& texturesFilePath, const ModelFileOptions& options = ModelFileOptions());
@@ -120,7 +120,7 @@ namespace engine::io {
     };
 
     template<typename T>
-    std::unordered_map<std::string, Model> ModelFile<T>::modelMap;
+    typename ModelFile<T>::ModelMap ModelFile<T>::modelMap;
 
     template<typename T>
     Model ModelFile<T>::readInternal(const std::string &filePath, const std::string& texturesFilePath, const ModelFileOptions& options) {
@@ -134,7 +134,7 @@ namespace engine::io {
 
         std::vector<ModelMesh> meshes;
         extractNodes(texturesFilePath, scene->mRootNode, scene, meshes);
-        return { meshes };
+        return { std::move(meshes) };
     }
 
     template<typename T>
@@ -149,7 +149,7 @@ namespace engine::io {
             aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
             ModelMesh modelMesh = extractMesh(mesh);
             modelMesh.material = extractMaterial(texturesFilePath, mesh, scene);
-            meshes.push_back(modelMesh);
+            meshes.push_back(std::move(modelMesh));
         }
         // recursively extract node's children
         for (uint32_t i = 0; i < node->mNumChildren; i++) {
@@ -159,8 +159,7 @@ namespace engine::io {
 
     template<typename T>
     ModelMesh ModelFile<T>::extractMesh(aiMesh *mesh) {
-        auto* vertices = new ModelVertex[mesh->mNumVertices];
-        std::vector<uint32_t> indicesVector;
+        array<ModelVertex> vertices(mesh->mNumVertices, graphics_allocator());
         // extract vertices
         for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
             // positions
@@ -199,22 +198,24 @@ namespace engine::io {
                 };
             }
         }
-        // extract indices
+        // extract indices, they are counted first, so they are written right into index data
+        u32 indexCount = 0;
         for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
-            auto face = mesh->mFaces[i];
+            indexCount += mesh->mFaces[i].mNumIndices;
+        }
+        array<u32> indices(indexCount, graphics_allocator());
+        u32 index = 0;
+        for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
+            auto& face = mesh->mFaces[i];
             for(uint32_t j = 0; j < face.mNumIndices; j++) {
-                indicesVector.push_back(face.mIndices[j]);
+                indices[index++] = face.mIndices[j];
             }
         }
 
-        array<ModelVertex> vertexData = { vertices, 0, mesh->mNumVertices };
-        graphics::IndexData indexData = {
-                engine::core::mapTo(indicesVector),
-                0,
-                static_cast<uint32_t>(indicesVector.size())
-        };
-
-        return { vertexData, indexData };
+        ModelMesh modelMesh;
+        modelMesh.vertexData = std::move(vertices);
+        modelMesh.indexData = std::move(indices);
+        return modelMesh;
     }
 
     template<typename T>
@@ -299,13 +300,14 @@ namespace engine::io {
     Model ModelFile<T>::read(const std::string &filepath, const std::string& texturesFilePath, const ModelFileOptions& options) {
         ENGINE_INFO("ModelFile: read='{0}'", filepath);
         // get a copy of mesh that's already loaded from a model file
-        if (exists(filepath)) {
-            return modelMap.at(filepath);
+        auto it = modelMap.find(filepath);
+        if (it != modelMap.end()) {
+            return it->second;
         }
         // load new mesh from model file
         try {
             auto model = readInternal(filepath, texturesFilePath, options);
-            modelMap.insert({ filepath, model });
+            modelMap.emplace(filepath, model);
             return model;
         } catch (const file_not_found& ex) {
             ENGINE_ERR("ModelFile: Failed to read file '{0}'", filepath);
@@ -5,13 +5,14 @@
 #pragma once
 
 #include <core/filesystem.h>
+#include <core/map.h>
 #include <platform/graphics/tools/ShaderPath.h>
 
 #include "string"
 
 namespace engine::io {
 
-    typedef std::unordered_map<std::string, std::string> ShadersStorage;
+    typedef core::unordered_map<std::string, std::string> ShadersStorage;
 
     class ENGINE_API ShaderFile final {
 
@@ -57,7 +57,7 @@ namespace engine::graphics {
         }
 
         void initCube() {
-            auto vertices = new HdrEnvVertex[36] {
+            geometry.vertexData = array<HdrEnvVertex>({
                     {{-1.0f,  1.0f, -1.0f}},
                     {{-1.0f, -1.0f, -1.0f}},
                     {{1.0f, -1.0f, -1.0f}},
@@ -94,9 +94,7 @@ namespace engine::graphics {
                     {{1.0f, -1.0f, -1.0f}},
                     {{-1.0f, -1.0f,  1.0f}},
                     {{1.0f, -1.0f,  1.0f}},
-            };
-
-            geometry.vertexData = { vertices, 0, 36 };
+            }, graphics_allocator());
             geometry.drawType = DrawType::TRIANGLE;
         }
     };
@@ -60,7 +60,7 @@ namespace engine::graphics {
         }
 
         void initCube() {
-            auto vertices = new SkyboxVertex[36] {
+            geometry.vertexData = array<SkyboxVertex>({
                     {{-1.0f,  1.0f, -1.0f}},
                     {{-1.0f, -1.0f, -1.0f}},
                     {{1.0f, -1.0f, -1.0f}},
@@ -97,9 +97,7 @@ namespace engine::graphics {
                     {{1.0f, -1.0f, -1.0f}},
                     {{-1.0f, -1.0f,  1.0f}},
                     {{1.0f, -1.0f,  1.0f}},
-            };
-
-            geometry.vertexData = { vertices, 0, 36 };
+            }, graphics_allocator());
             geometry.drawType = DrawType::TRIANGLE;
         }
     };
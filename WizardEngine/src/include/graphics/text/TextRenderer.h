@@ -23,6 +23,7 @@ namespace engine::graphics {
 
     public:
         void render(ecs::Registry& registry) override;
+        void onExtract(ecs::Registry& registry) override;
 
     private:
         void init();
@@ -33,6 +34,15 @@ namespace engine::graphics {
         vRenderModels.emplace_back(createRenderModel(DEFAULT_VERTEX_COUNT));
     }
 
+    template<typename Text>
+    void TextRenderer<Text>::onExtract(ecs::Registry& registry) {
+        if (registry.empty_components<Text>()) return;
+
+        registry.each<Text>([](Text* text) {
+            text->isUpdated = false;
+        });
+    }
+
     template<typename Text>
     void TextRenderer<Text>::render(ecs::Registry &registry) {
         if (!shaderProgram.isReady() || registry.empty_entity() || registry.empty_components<Text>()) return;
@@ -111,7 +121,8 @@ namespace engine::graphics {
                     float h = character.size.y();
 
                     if (vertexDataComponent.isUpdated) {
-                        auto& vertices = vertexDataComponent.vertexData.values;
+                        // glyph vertices of font are shared, so they are copied before placing the char
+                        auto vertices = vertexDataComponent.vertexData.edit();
                         vertices[3].vertex.position = { x, y };
                         vertices[2].vertex.position = { x + w, y };
                         vertices[1].vertex.position = { x + w, y + h };
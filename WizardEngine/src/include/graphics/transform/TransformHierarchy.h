@@ -0,0 +1,48 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <graphics/transform/TransformComponents.h>
+#include <ecs/Scene.h>
+
+namespace engine::graphics {
+
+    using namespace ecs;
+
+    // parent/child link of entity, Transform3dComponent of child is local to its parent
+    // local and world matrices are cached, world matrix is also written into transform model matrix for renderers
+    component(HierarchyComponent) {
+        entity_id parent = invalid_entity_id;
+        vector<entity_id> children;
+        u32 depth = 0; // 0 for roots
+        math::mat4f localMatrix;
+        math::mat4f worldMatrix;
+        component_version updateVersion = 0; // registry version, when world matrix was scheduled for update last time
+    };
+
+    // count of entities, which world matrices are updated by single thread pool job
+    constexpr u32 hierarchy_grain = 128;
+
+    class ENGINE_API TransformHierarchy final {
+
+    public:
+        // links child to parent, invalid_entity_id parent makes child a root
+        static void setParent(Registry& registry, entity_id child, entity_id parent);
+        // recomputes world matrices of changed transforms and of their descendants, level by level
+        // transform changes are taken from registry versions, so writers should call Registry::markChanged<Transform3dComponent>()
+        static void onUpdate();
+
+    private:
+        static void setDepth(Registry& registry, HierarchyComponent& hierarchy, u32 depth);
+        static void updateWorld(Registry& registry, entity_id entityId, bool localChanged);
+
+    public:
+        static Ref<Scene> activeScene;
+
+    private:
+        static Scene* updatedScene;
+        static component_version updatedVersion;
+    };
+}
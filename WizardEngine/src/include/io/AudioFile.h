@@ -22,8 +22,11 @@ namespace engine::io {
         ~AudioFile() = default;
 
     public:
+        // data is taken from heap_allocator(MemoryTag::AUDIO) and must be released by releaseWav()
         static AudioData readWav(const char* filepath);
-        static char* streamWav(const s64& dataOffset, const s64& dataSize);
+        static void releaseWav(AudioData& audioData);
+        // reads dataSize bytes of opened file into data
+        static void streamWav(char* data, const s64& dataOffset, const s64& dataSize);
         static AudioFormat readWavHeaders(const char* filepath);
 
         static void open(const char* filepath);
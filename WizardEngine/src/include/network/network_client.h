@@ -127,7 +127,12 @@ namespace engine::network {
             void connectImpl(const std::string& ip, int port);
 
             SOCKET clientSocket;
-            bool connecting = false;
+            std::atomic<bool> connecting = false;
+            // connect blocks until OS timeout, so it gets its own thread instead of blocking task executor
+            thread::VoidTask<const std::string&, const int&> connectTask;
+            // pending retry of failed connection, cancelled by close()
+            std::mutex retryMutex;
+            core::TimerHandle retryTimer;
             ClientListener* listener = nullptr;
             Ref<Sender> sender = createRef<Sender>();
             Ref<Receiver> receiver = createRef<Receiver>();
@@ -14,6 +14,9 @@ namespace engine::physics {
 
     typedef std::function<void(entity_id, entity_id)> CollisionCallback;
 
+    // count of entities simulated by single thread pool job
+    constexpr u32 simulation_grain = 256;
+
     struct ENGINE_API PhysicsCallback {
         // collision callbacks
         CollisionCallback onCollided = [](entity_id, entity_id){};
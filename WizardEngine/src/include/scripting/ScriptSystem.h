@@ -11,6 +11,9 @@ namespace engine::scripting {
 
     using namespace core;
 
+    // count of native scripts updated by single thread pool job
+    constexpr u32 script_grain = 64;
+
     class ENGINE_API ScriptSystem final {
 
     public:
@@ -6,46 +6,166 @@
 
 #include <io/Logger.h>
 #include <thread/Thread.h>
+#include <core/job_system.h>
+
+#include <tuple>
+#include <mutex>
+#include <condition_variable>
 
 namespace engine::thread {
 
+    // short tasks share workers of this executor, instead of creating a thread for each run
+    constexpr size_t task_executor_jobs = 64;
+    typedef core::JobScheduler<task_executor_jobs> TaskExecutor;
+    // created on first use, callers block while its queue is full
+    ENGINE_API TaskExecutor& taskExecutor();
+
+    // result of single Task::run(), invalid if run was skipped
+    // future of a run, which was cancelled before it started, is broken
+    template<typename Result>
+    struct TaskHandle {
+        std::shared_future<Result> future;
+        core::Ref<std::atomic<bool>> cancelled;
+
+        inline void cancel() const {
+            if (cancelled) {
+                cancelled->store(true);
+            }
+        }
+
+        [[nodiscard]] inline bool isValid() const {
+            return future.valid();
+        }
+
+        [[nodiscard]] inline bool isDone() const {
+            return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        inline void wait() const {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+    };
+
     template<typename Runnable, typename Done, typename... Args>
     struct ENGINE_API Task {
+        typedef typename std::function<Runnable>::result_type Result;
+
         const char* name = "Default_Task";
         const char* threadName = "Default_Thread";
-        bool isRunning = false;
+        // long-lived tasks, e.g. network loops, get dedicated thread, others run on taskExecutor()
+        bool isLongLived = false;
         std::function<Runnable> runnable;
         std::function<Done> done = [](){};
-        std::function<void(Args&&...)> runImpl = [this](Args&&... args) {
-            isRunning = true;
-            runnable(args...);
-            done();
-            isRunning = false;
-        };
 
         Task() = default;
 
         Task(const char* name,
              const char* threadName,
              const std::function<Runnable>& runnable,
-             const std::function<Done>& done = nullptr
-        ) : name(name), threadName(threadName), runnable(runnable), done(done) {}
+             const std::function<Done>& done = nullptr,
+             bool isLongLived = false
+        ) : name(name), threadName(threadName), isLongLived(isLongLived), runnable(runnable), done(done) {}
+
+        // set from run() until stop() or until task ends, long-lived tasks loop while it's set
+        [[nodiscard]] inline bool isRunning() const {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return state->active && state->token->load();
+        }
 
-        void run(Args &&... args) {
-            if (isRunning) return;
-            ENGINE_INFO("Running Task: {0}; Thread: {1}", name, threadName);
-            std::thread(runImpl, args...).detach();
+        // long-lived task leaves its loop and next run() is not skipped
+        // stops only current run, so task, which is run again, is not stopped by previous stop()
+        inline void stop() {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->token->store(false);
         }
+
+        // skipped, if task is still running, see stop()
+        // waits until stopped run leaves its loop, so two runs never share task resources
+        // runnable, done and args are copied, so task may be changed or destroyed while it runs
+        TaskHandle<Result> run(Args&&... args);
+
+    private:
+        struct State {
+            std::mutex mutex;
+            std::condition_variable exited;
+            // set from run() until job really exits
+            bool active = false;
+            // stop token of current run
+            core::Ref<std::atomic<bool>> token = core::createRef<std::atomic<bool>>(false);
+        };
+        // shared with running jobs, so local tasks may go out of scope
+        core::Ref<State> state = core::createRef<State>();
     };
 
+    template<typename Runnable, typename Done, typename... Args>
+    TaskHandle<typename Task<Runnable, Done, Args...>::Result> Task<Runnable, Done, Args...>::run(Args&&... args) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->active && state->token->load()) return {};
+            state->exited.wait(lock, [this]() { return !state->active; });
+            state->active = true;
+            state->token = core::createRef<std::atomic<bool>>(true);
+        }
+        ENGINE_INFO("Running Task: {0}; Thread: {1}", name, threadName);
+
+        auto promise = core::createRef<std::promise<Result>>();
+        TaskHandle<Result> handle = { promise->get_future().share(), core::createRef<std::atomic<bool>>(false) };
+        auto job = [
+                runnable = runnable,
+                done = done,
+                arguments = std::tuple<std::decay_t<Args>...>(args...),
+                state = state,
+                cancelled = handle.cancelled,
+                promise
+        ]() mutable {
+            auto exit = [&state]() {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->active = false;
+                state->exited.notify_all();
+            };
+            if (cancelled->load()) {
+                exit();
+                return;
+            }
+            // future is ready after done(), and task can be run again right away
+            if constexpr (std::is_void_v<Result>) {
+                std::apply(runnable, arguments);
+                if (done) {
+                    done();
+                }
+                exit();
+                promise->set_value();
+            } else {
+                Result result = std::apply(runnable, arguments);
+                if (done) {
+                    done();
+                }
+                exit();
+                promise->set_value(std::move(result));
+            }
+        };
+
+        if (isLongLived) {
+            std::thread thread(std::move(job));
+            setThreadFormat(0, thread, ThreadFormat(ThreadPriority::NORMAL, threadName));
+            thread.detach();
+        } else {
+            taskExecutor().execute(std::move(job));
+        }
+        return handle;
+    }
+
     template<typename... Args>
     struct ENGINE_API VoidTask : public Task<void(Args...), void(), Args...> {
         VoidTask() : Task<void(Args...), void(), Args...>() {}
         VoidTask(const char* name,
                  const char* threadName,
                  const std::function<void(Args...)>& runnable = [](Args... args){},
-                 const std::function<void()>& done = [](){}
-        ) : Task<void(Args...), void(), Args...>(name, threadName, runnable, done) {}
+                 const std::function<void()>& done = [](){},
+                 bool isLongLived = false
+        ) : Task<void(Args...), void(), Args...>(name, threadName, runnable, done, isLongLived) {}
     };
 
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <core/core.h>
 #include <core/primitives.h>
+#include <core/vector.h>
 #include <time/Time.h>
 
 #include <future>
@@ -19,13 +21,30 @@ namespace engine::thread {
     struct ENGINE_API ThreadFormat {
         ThreadPriority priority;
         const char* name;
+        // index into CpuTopology::cpus for thread 0, next threads take next cpus, -1 - thread is not pinned
+        s32 firstCpu = -1;
 
-        ThreadFormat(ThreadPriority newPriority, const char* newName)
-        : priority(newPriority), name(newName) {}
+        ThreadFormat(ThreadPriority newPriority, const char* newName, s32 newFirstCpu = -1)
+        : priority(newPriority), name(newName), firstCpu(newFirstCpu) {}
+    };
+
+    // logical CPUs, that this process is allowed to run on
+    struct ENGINE_API CpuTopology {
+        u32 logicalCount = 1;
+        // distinct physical cores among logical CPUs, less than logicalCount with SMT
+        u32 physicalCount = 1;
+        // logical CPU ids: first thread of each core, then their SMT siblings
+        vector<u32> cpus;
+
+        [[nodiscard]] inline bool hasSMT() const {
+            return physicalCount < logicalCount;
+        }
     };
 
     ENGINE_API void current_sleep(const u32 &millis);
     ENGINE_API u32 cpu_cores_count();
+    // read once, from /sys and process affinity on Linux
+    ENGINE_API const CpuTopology& cpu_topology();
     ENGINE_API u32 currentThreadId();
     ENGINE_API void setThreadFormat(u32 id, std::thread& thread, const ThreadFormat& format);
 }
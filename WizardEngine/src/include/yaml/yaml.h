@@ -119,18 +119,43 @@ namespace YAML {
 
         static Node encode(const array<T>& array) {
             Node node;
-            array.forEach([&node](const T& item) {
-               node.push_back(item);
-            });
+            for (const T& item : array) {
+                node.push_back(item);
+            }
             return node;
         }
 
         static bool decode(const Node& node, array<T>& array) {
+            if (!node.IsSequence()) return false;
+
+            array = engine::core::array<T>(node.size());
+            for (u32 i = 0 ; i < array.size() ; i++) {
+                array[i] = node[i].as<T>();
+            }
+            return true;
+        }
+    };
+
+    template<typename T>
+    struct convert<shared_array<T>> {
+
+        static Node encode(const shared_array<T>& array) {
+            Node node;
+            node["offset"] = array.offset;
+            node["size"] = array.size();
+            Node values;
+            for (const T& item : array) {
+                values.push_back(item);
+            }
+            node["values"] = values;
+            return node;
+        }
+
+        static bool decode(const Node& node, shared_array<T>& array) {
+            if (!node.IsMap()) return false;
+
+            array = node["values"].as<engine::core::array<T>>();
             array.offset = node["offset"].as<u32>();
-            array.size = node["size"].as<u32>();
-            array.forEach([&node](T& item, u32 i) {
-                item = node[i].as<T>();
-            });
             return true;
         }
     };
@@ -200,32 +225,32 @@ namespace engine::yaml {
     }
 
     template<typename T, typename Function>
-    void serialize(YAML::Emitter& out, const char* key, const array<T>& array, const Function& function) {
+    void serialize(YAML::Emitter& out, const char* key, const shared_array<T>& array, const Function& function) {
         out << YAML::BeginMap;
         out << YAML::Key << key;
 
         serialize(out, "offset", array.offset);
-        serialize(out, "size", array.size);
+        serialize(out, "size", array.size());
 
         out << YAML::Key << "values" << YAML::Value << YAML::Flow;
         out << YAML::BeginSeq;
-        array.forEach([&out, &function](const T& item) {
+        for (const T& item : array) {
             function(out, item);
-        });
+        }
         out << YAML::EndSeq;
 
         out << YAML::EndMap;
     }
 
     template<typename T>
-    void serialize(YAML::Emitter& out, const char* key, const array<T>& array) {
+    void serialize(YAML::Emitter& out, const char* key, const shared_array<T>& array) {
         serialize(out, key, array, [](YAML::Emitter& out, const T& item) {
             out << item;
         });
     }
 
     template<typename T>
-    void deserialize(const YAML::Node& parent, const char* key, array<T>& array) {
-        array = parent[key].as<engine::core::array<T>>();
+    void deserialize(const YAML::Node& parent, const char* key, shared_array<T>& array) {
+        array = parent[key].as<engine::core::shared_array<T>>();
     }
 }
\ No newline at end of file
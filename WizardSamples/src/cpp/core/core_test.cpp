@@ -0,0 +1,589 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#include <core.h>
+#include <core/core_test.h>
+#include <core/frame_allocator.h>
+#include <core/array.h>
+#include <core/map.h>
+#include <thread/Task.h>
+
+namespace test::core {
+
+    void test_jobScheduler() {
+        // fine-grained jobs from outside and from workers, which are spread by stealing
+        std::atomic<u32> counter { 0 };
+        {
+            engine::core::JobScheduler<16> scheduler(4, engine::thread::ThreadFormat(engine::thread::NORMAL, "TestWorker"));
+            for (u32 i = 0 ; i < 200 ; i++) {
+                scheduler.execute([&scheduler, &counter]() {
+                    for (u32 j = 0 ; j < 50 ; j++) {
+                        scheduler.execute([&counter]() {
+                            counter.fetch_add(1, std::memory_order_relaxed);
+                        });
+                    }
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+            scheduler.wait();
+            assert_equals("test_jobScheduler(): all jobs done", counter.load(), 200 * 51)
+
+            // workers park when idle and wake up for new jobs
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            scheduler.execute(4000, 100, [&counter](engine::core::JobArgs) {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+            scheduler.wait();
+            assert_equals("test_jobScheduler(): jobs after parking", counter.load(), 200 * 51 + 4000)
+        }
+        // scheduler destructor stops and joins parked workers
+        assert_equals("test_jobScheduler(): stopped", counter.load(), 200 * 51 + 4000)
+    }
+
+    void test_jobHandles() {
+        using namespace engine::core;
+
+        for (bool callersHelp : { true, false }) {
+            JobScheduler<16> scheduler(2, engine::thread::ThreadFormat(engine::thread::NORMAL, "TestWorker"), callersHelp);
+            std::atomic<u32> stage { 0 };
+            std::atomic<bool> ordered { true };
+
+            // A and B run first, C after both of them, D after C
+            JobHandle a = scheduler.execute([&stage]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                stage.fetch_add(1);
+            });
+            JobHandle b = scheduler.execute([&stage]() {
+                stage.fetch_add(1);
+            });
+            JobHandle c = scheduler.execute(dependsOn(a, b), [&stage, &ordered]() {
+                ordered = ordered && stage.load() == 2;
+                stage.fetch_add(1);
+            });
+            JobHandle d = scheduler.execute(c, [&stage, &ordered]() {
+                ordered = ordered && stage.load() == 3;
+                stage.fetch_add(1);
+            });
+            scheduler.waitFor(d);
+            bool done = stage.load() == 4 && a.isDone() && b.isDone() && c.isDone() && d.isDone();
+            assert_equals("test_jobHandles(): dependencies order", ordered.load(), true)
+            assert_equals("test_jobHandles(): waitFor()", done, true)
+
+            // continuation of done handle runs right away
+            bool continued = false;
+            d.then([&continued]() {
+                continued = true;
+            });
+            assert_equals("test_jobHandles(): continuation of done job", continued, true)
+
+            // jobs wait for other jobs by running them
+            std::atomic<u32> counter { 0 };
+            vector<JobHandle> handles;
+            for (u32 i = 0 ; i < 8 ; i++) {
+                handles.emplace_back(scheduler.execute([&scheduler, &counter]() {
+                    vector<JobHandle> inner;
+                    for (u32 j = 0 ; j < 16 ; j++) {
+                        inner.emplace_back(scheduler.execute([&counter]() {
+                            counter.fetch_add(1);
+                        }));
+                    }
+                    scheduler.waitFor(dependsOn(inner));
+                }));
+            }
+            scheduler.waitFor(dependsOn(handles));
+            assert_equals("test_jobHandles(): nested waitFor()", counter.load(), 8 * 16)
+            scheduler.wait();
+        }
+    }
+
+    void test_jobStorage() {
+        using namespace engine::core;
+
+        auto marker = createRef<std::atomic<u32>>(0);
+        auto small = [marker]() { (*marker)++; };
+        struct Large { u8 data[128] = {}; };
+        auto large = [marker, payload = Large()]() { (*marker) += 1 + payload.data[0]; };
+        assert_equals("test_jobStorage(): small closure is inline", Job::isInline<decltype(small)>(), true)
+        assert_equals("test_jobStorage(): large closure is on heap", Job::isInline<decltype(large)>(), false)
+
+        {
+            Job smallJob(small);
+            Job largeJob(large);
+            // moved jobs keep their closures
+            Job movedSmall(std::move(smallJob));
+            Job movedLarge;
+            movedLarge = std::move(largeJob);
+            bool moved = !smallJob && !largeJob && movedSmall && movedLarge;
+            assert_equals("test_jobStorage(): moved jobs", moved, true)
+            movedSmall();
+            movedLarge();
+            assert_equals("test_jobStorage(): jobs executed", marker->load(), 2)
+            assert_equals("test_jobStorage(): captures alive", marker.use_count(), 5)
+        }
+        assert_equals("test_jobStorage(): captures released", marker.use_count(), 3)
+
+        // recycled jobs release their captures after run
+        JobScheduler<16> scheduler(2, engine::thread::ThreadFormat(engine::thread::NORMAL, "TestWorker"));
+        for (u32 frame = 0 ; frame < 10 ; frame++) {
+            scheduler.execute(1000, 1, [marker](JobArgs) {
+                (*marker)++;
+            });
+            scheduler.execute([marker, payload = Large()]() {
+                (*marker) += 1 + payload.data[0];
+            });
+            scheduler.wait();
+        }
+        assert_equals("test_jobStorage(): scheduled jobs executed", marker->load(), 2 + 10 * 1001)
+        assert_equals("test_jobStorage(): scheduled captures released", marker.use_count(), 3)
+    }
+
+    void test_jobSystem() {
+        const engine::thread::CpuTopology& topology = engine::thread::cpu_topology();
+        assert_equals("test_jobSystem(): logical CPUs", (u32) topology.cpus.size(), topology.logicalCount)
+        assert_equals("test_jobSystem(): physical cores", topology.physicalCount <= topology.logicalCount, true)
+        assert_equals("test_jobSystem(): cpu_cores_count()", engine::thread::cpu_cores_count(), topology.logicalCount)
+
+        // pinned workers must still run all jobs of every lane
+        JobSystem<> jobSystem(true);
+        std::atomic<u32> counter { 0 };
+        jobSystem.renderScheduler->execute([&counter]() { counter.fetch_add(1); });
+        jobSystem.audioScheduler->execute([&counter]() { counter.fetch_add(1); });
+        jobSystem.networkScheduler->execute([&counter]() { counter.fetch_add(1); });
+        jobSystem.threadPoolScheduler->parallelFor(64, 4, [&counter](JobArgs) { counter.fetch_add(1); });
+        jobSystem.waitAll();
+        assert_equals("test_jobSystem(): jobs of all lanes", counter.load(), 3 + 64)
+        assert_equals("test_jobSystem(): shared lane", jobSystem.isSharedLane(), topology.logicalCount <= job_system_small_cpus)
+    }
+
+    void test_tasks() {
+        using namespace engine::thread;
+
+        // results are returned through futures
+        Task<u32(const u32&), void(), const u32&> squareTask = { "Square_Task", "Square_Thread", [](const u32& value) { return value * value; } };
+        TaskHandle<u32> square = squareTask.run(7);
+        assert_equals("test_tasks(): result", square.future.get(), 49u)
+
+        // executor workers are blocked, so queued run can be cancelled before it starts
+        std::promise<void> gate;
+        std::shared_future<void> opened = gate.get_future().share();
+        vector<Scope<VoidTask<>>> blockers;
+        vector<TaskHandle<void>> blocked;
+        for (u32 i = 0 ; i < taskExecutor().getWorkerSize() ; i++) {
+            blockers.emplace_back(createScope<VoidTask<>>("Blocker_Task", "Blocker_Thread", [opened]() { opened.wait(); }));
+            blocked.emplace_back(blockers.back()->run());
+        }
+        std::atomic<bool> executed { false };
+        VoidTask<> cancelledTask = { "Cancelled_Task", "Cancelled_Thread", [&executed]() { executed.store(true); } };
+        TaskHandle<void> cancelled = cancelledTask.run();
+        assert_equals("test_tasks(): skipped while running", cancelledTask.run().isValid(), false)
+        cancelled.cancel();
+        gate.set_value();
+        cancelled.wait();
+        for (const auto& handle : blocked) {
+            handle.wait();
+        }
+        assert_equals("test_tasks(): cancelled", executed.load(), false)
+        assert_equals("test_tasks(): cancelled task is not running", cancelledTask.isRunning(), false)
+
+        // long-lived task loops on own thread until stopped
+        std::atomic<u32> loops { 0 };
+        VoidTask<> loopTask = { "Loop_Task", "Loop_Thread", [&loops, &loopTask]() {
+            while (loopTask.isRunning()) {
+                loops.fetch_add(1);
+                std::this_thread::yield();
+            }
+        }, [](){}, true };
+        TaskHandle<void> loop = loopTask.run();
+        while (loops.load() < 10) {
+            std::this_thread::yield();
+        }
+        loopTask.stop();
+        loop.wait();
+        assert_equals("test_tasks(): long-lived task stopped", loop.isDone(), true)
+
+        // task run right after stop starts, when previous loop has left, and is not stopped by it
+        std::atomic<u32> activeLoops { 0 };
+        std::atomic<bool> overlapped { false };
+        VoidTask<> restartTask = { "Restart_Task", "Restart_Thread", [&activeLoops, &overlapped, &restartTask]() {
+            if (activeLoops.fetch_add(1) > 0) {
+                overlapped.store(true);
+            }
+            while (restartTask.isRunning()) {
+                std::this_thread::yield();
+            }
+            activeLoops.fetch_sub(1);
+        }, [](){}, true };
+        TaskHandle<void> first = restartTask.run();
+        restartTask.stop();
+        TaskHandle<void> second = restartTask.run();
+        assert_equals("test_tasks(): restarted", second.isValid(), true)
+        first.wait();
+        assert_equals("test_tasks(): restarted task is running", restartTask.isRunning(), true)
+        assert_equals("test_tasks(): restarted task is not done", second.isDone(), false)
+        restartTask.stop();
+        second.wait();
+        assert_equals("test_tasks(): restarted loops not overlapped", overlapped.load(), false)
+    }
+
+    void test_timerWheel() {
+        TimerWheel wheel;
+        vector<u64> fired;
+        auto timer = [&wheel, &fired](u64 delay, u64 period = 0) {
+            return wheel.insert(delay, period, createRef<std::function<void()>>([&wheel, &fired]() {
+                fired.emplace_back(wheel.getTick());
+            }));
+        };
+        auto advance = [&wheel](u64 tick) {
+            vector<TimerFunction> expired;
+            wheel.advance(tick, expired);
+            for (const auto& function : expired) {
+                (*function)();
+            }
+        };
+
+        // timers of every level fire exactly at their tick
+        vector<u64> delays = { 1, 63, 64, 65, 100, 4095, 4096, 5000, 300000, 20000000 };
+        for (u64 delay : delays) {
+            timer(delay);
+        }
+        TimerHandle cancelled = timer(70);
+        assert_equals("test_timerWheel(): cancel", wheel.cancel(cancelled), true)
+        assert_equals("test_timerWheel(): cancel twice", wheel.cancel(cancelled), false)
+        for (u32 i = 0 ; i < delays.size() ; i++) {
+            advance(delays[i] - 1);
+            assert_equals("test_timerWheel(): not fired early", fired.size(), i)
+            advance(delays[i]);
+            assert_equals("test_timerWheel(): fired", fired.size(), i + 1)
+            assert_equals("test_timerWheel(): fired tick", fired[i], delays[i])
+        }
+        assert_equals("test_timerWheel(): empty", wheel.size(), 0u)
+
+        // periodic timer fires each period, until cancelled
+        fired.clear();
+        u64 start = wheel.getTick();
+        TimerHandle periodic = timer(10, 10);
+        for (u32 i = 1 ; i <= 3 ; i++) {
+            advance(start + i * 10 - 1);
+            assert_equals("test_timerWheel(): periodic not fired early", fired.size(), i - 1)
+            advance(start + i * 10);
+            assert_equals("test_timerWheel(): periodic fired", fired.size(), i)
+        }
+        // periods missed by late advance are skipped
+        advance(start + 60);
+        assert_equals("test_timerWheel(): periodic catch up", fired.size(), 4)
+        advance(start + 69);
+        assert_equals("test_timerWheel(): periodic phase", fired.size(), 4)
+        advance(start + 70);
+        assert_equals("test_timerWheel(): periodic after catch up", fired.size(), 5)
+        assert_equals("test_timerWheel(): cancel periodic", wheel.cancel(periodic), true)
+        advance(wheel.getTick() + 100);
+        assert_equals("test_timerWheel(): cancelled periodic", fired.size(), 5)
+
+        // released timers are reused with new generation, so old handles stay stale
+        TimerHandle reused = timer(5);
+        assert_equals("test_timerWheel(): reused index", reused.index, periodic.index)
+        assert_equals("test_timerWheel(): stale handle", wheel.cancel(periodic), false)
+        assert_equals("test_timerWheel(): new handle", wheel.cancel(reused), true)
+    }
+
+    void test_timers() {
+        JobScheduler<16> scheduler(2, engine::thread::ThreadFormat(engine::thread::NORMAL, "TestWorker"));
+        std::atomic<bool> delayed { false };
+        std::atomic<u32> ticks { 0 };
+        auto start = std::chrono::steady_clock::now();
+        scheduler.executeAfter(std::chrono::milliseconds(20), [&delayed]() {
+            delayed.store(true);
+        });
+        TimerHandle periodic = scheduler.executeEvery(std::chrono::milliseconds(2), [&ticks]() {
+            ticks.fetch_add(1);
+        });
+        TimerHandle cancelled = scheduler.executeAfter(std::chrono::milliseconds(10), [&delayed]() {
+            delayed.store(false);
+        });
+        assert_equals("test_timers(): cancel", scheduler.cancelTimer(cancelled), true)
+
+        while (!delayed.load() || ticks.load() < 5) {
+            std::this_thread::yield();
+        }
+        assert_equals("test_timers(): delay", std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20), true)
+        assert_equals("test_timers(): cancel periodic", scheduler.cancelTimer(periodic), true)
+        // job, that fired right before cancel, may be still on the way to job queue
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        scheduler.wait();
+        u32 stoppedTicks = ticks.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        assert_equals("test_timers(): periodic stopped", ticks.load(), stoppedTicks)
+    }
+
+    void test_frameArena() {
+        FrameArena::nextFrame();
+        FrameArena& arena = FrameArena::get();
+        void* aligned = arena.allocate(24, 64);
+        assert_equals("test_frameArena(): alignment", (uintptr_t) aligned % 64, 0)
+        assert_equals("test_frameArena(): used", arena.getUsed(), 24)
+        // only last allocation is rolled back
+        void* last = arena.allocate(16);
+        arena.deallocate(last, 16);
+        assert_equals("test_frameArena(): rollback", arena.allocate(16), last)
+        arena.deallocate(aligned, 24);
+        assert_equals("test_frameArena(): no rollback", arena.getUsed(), 40)
+
+        void* oversized = arena.allocate(frame_arena_block_size * 2);
+        assert_equals("test_frameArena(): oversized", oversized != nullptr, true)
+        frame_vector<u32> values;
+        for (u32 i = 0 ; i < 1000 ; i++) {
+            values.emplace_back(i);
+        }
+        u32 sum = 0;
+        for (u32 value : values) {
+            sum += value;
+        }
+        assert_equals("test_frameArena(): frame vector", sum, 499500)
+        size_t capacity = arena.getCapacity();
+        size_t peak = arena.getPeak();
+        values = {};
+
+        // next frame reuses memory of previous one, merged into single block
+        FrameArena::nextFrame();
+        void* reused = arena.allocate(8);
+        assert_equals("test_frameArena(): reset", arena.getUsed(), 8)
+        assert_equals("test_frameArena(): peak", arena.getPeak(), peak)
+        assert_equals("test_frameArena(): capacity", arena.getCapacity(), capacity)
+        assert_equals("test_frameArena(): no growth", arena.allocate(frame_arena_block_size * 2) != nullptr, true)
+        assert_equals("test_frameArena(): merged", arena.getCapacity(), capacity)
+        arena.deallocate(reused, 8);
+
+        // each thread allocates from its own arena
+        FrameArena* threadArena = nullptr;
+        std::thread thread([&threadArena]() {
+            threadArena = &FrameArena::get();
+            threadArena->allocate(32);
+        });
+        thread.join();
+        assert_equals("test_frameArena(): thread arena", threadArena != &arena, true)
+    }
+
+    void test_allocators() {
+        // tagged heap is tracked per subsystem
+        Allocator& audioHeap = heap_allocator(MemoryTag::AUDIO);
+        MemoryStats audioStats = MemoryTracker::getStats(MemoryTag::AUDIO);
+        void* samples = audioHeap.allocate(1000, 64);
+        assert_equals("test_allocators(): aligned", (uintptr_t) samples % 64, 0)
+        assert_equals("test_allocators(): tracked", MemoryTracker::getStats(MemoryTag::AUDIO).allocated, audioStats.allocated + 1000)
+        audioHeap.deallocate(samples, 1000, 64);
+        assert_equals("test_allocators(): untracked", MemoryTracker::getStats(MemoryTag::AUDIO).allocated, audioStats.allocated)
+
+        // released pool blocks are reused first
+        PoolAllocator pool(24, 8, 4, heap_allocator(MemoryTag::NETWORK));
+        void* blocks[5];
+        for (void*& block : blocks) {
+            block = pool.allocate(24, 8);
+        }
+        assert_equals("test_allocators(): pool pages", pool.getPageCount(), 2)
+        pool.deallocate(blocks[2], 24, 8);
+        assert_equals("test_allocators(): pool reuse", pool.allocate(24, 8), blocks[2])
+        for (void* block : blocks) {
+            pool.deallocate(block, 24, 8);
+        }
+        assert_equals("test_allocators(): pool used", pool.getUsedBlocks(), 0)
+
+        // free blocks are merged, so region fits big block again
+        FreeListAllocator freeList(kb_4);
+        void* a = freeList.allocate(1000);
+        void* b = freeList.allocate(1000, 256);
+        void* c = freeList.allocate(1000);
+        assert_equals("test_allocators(): free list alignment", (uintptr_t) b % 256, 0)
+        freeList.deallocate(a, 1000);
+        freeList.deallocate(c, 1000);
+        freeList.deallocate(b, 1000, 256);
+        assert_equals("test_allocators(): free list used", freeList.getUsed(), 0)
+        void* big = freeList.allocate(kb_4 - 64);
+        assert_equals("test_allocators(): free list merged", freeList.getCapacity(), kb_4)
+        freeList.deallocate(big, kb_4 - 64);
+
+        ArenaAllocator arena(256);
+        arena.allocate(200);
+        arena.allocate(200);
+        assert_equals("test_allocators(): arena blocks", arena.getCapacity(), 512)
+        arena.reset();
+        arena.allocate(400);
+        assert_equals("test_allocators(): arena merged", arena.getCapacity(), 512)
+
+        // objects and containers placed into engine allocators
+        struct Base {
+            virtual ~Base() = default;
+            u32 value = 1;
+        };
+        struct Other {
+            virtual ~Other() = default;
+            u64 other = 2;
+        };
+        struct Derived : Other, Base {
+            u32* destroyed;
+            explicit Derived(u32* destroyed) : destroyed(destroyed) {}
+            ~Derived() override { (*destroyed)++; }
+        };
+        u32 destroyed = 0;
+        FreeListAllocator objects(kb_1);
+        {
+            AllocatedScope<Base> scope = createScope<Derived>(objects, &destroyed);
+            Ref<Derived> ref = createRef<Derived>(objects, &destroyed);
+            std::vector<u32, StdAllocator<u32>> values(objects);
+            values.assign(100, 1);
+            assert_equals("test_allocators(): placed", objects.getUsed() > sizeof(Derived) * 2 + 400, true)
+        }
+        assert_equals("test_allocators(): destroyed", destroyed, 2)
+        assert_equals("test_allocators(): released", objects.getUsed(), 0)
+    }
+
+    void test_arrays() {
+        struct Vertex {
+            f32 position[3] = { 0, 0, 0 };
+            f32 id = 0;
+        };
+
+        // values are aligned and accounted to allocator tag
+        Allocator& graphicsHeap = heap_allocator(MemoryTag::GRAPHICS);
+        size_t allocated = MemoryTracker::getStats(MemoryTag::GRAPHICS).allocated;
+        {
+            array<Vertex> vertices(100, graphicsHeap);
+            assert_equals("test_arrays(): aligned", (uintptr_t) vertices.data() % array_alignment, 0)
+            assert_equals("test_arrays(): tracked", MemoryTracker::getStats(MemoryTag::GRAPHICS).allocated, allocated + 100 * sizeof(Vertex))
+            assert_equals("test_arrays(): initialized", vertices[99].id, 0)
+
+            // move leaves source empty, so values are released once
+            Vertex* values = vertices.data();
+            array<Vertex> moved = std::move(vertices);
+            assert_equals("test_arrays(): moved", moved.data(), values)
+            assert_equals("test_arrays(): moved from", vertices.empty(), true)
+
+            array<Vertex> copied = moved.copy();
+            assert_equals("test_arrays(): deep copy", copied.data() != moved.data(), true)
+            assert_equals("test_arrays(): copy size", copied.size(), 100)
+        }
+        assert_equals("test_arrays(): released", MemoryTracker::getStats(MemoryTag::GRAPHICS).allocated, allocated)
+
+        array<u32> indices({ 0, 1, 2, 2, 3, 0 }, graphicsHeap);
+        u32 sum = 0;
+        for (u32 index : indices.view().subview(3, 3)) {
+            sum += index;
+        }
+        assert_equals("test_arrays(): view", sum, 5)
+
+        array<f32> ids = indices.map([](const u32& index) { return (f32) index * 2; });
+        assert_equals("test_arrays(): map", ids[3], 4)
+        assert_equals("test_arrays(): map allocator", ids.getAllocator(), &graphicsHeap)
+
+        // copies share values, until one of them is edited
+        shared_array<Vertex> mesh = array<Vertex>(4, graphicsHeap);
+        mesh.offset = 10;
+        shared_array<Vertex> snapshot = mesh;
+        assert_equals("test_arrays(): shared", snapshot.data(), mesh.data())
+        assert_equals("test_arrays(): is shared", mesh.isShared(), true)
+
+        for (auto& vertex : mesh.edit()) {
+            vertex.id = 1;
+        }
+        assert_equals("test_arrays(): detached", snapshot.data() != mesh.data(), true)
+        assert_equals("test_arrays(): edited", mesh[3].id, 1)
+        assert_equals("test_arrays(): snapshot kept", snapshot[3].id, 0)
+        assert_equals("test_arrays(): offset", snapshot.offset, 10)
+
+        const Vertex* values = mesh.data();
+        mesh.edit()[0].id = 2;
+        assert_equals("test_arrays(): edit in place", mesh.data(), values)
+    }
+
+    void test_flatMap() {
+        flat_map<u32, u32> squares;
+        squares.reserve(100);
+        size_t capacity = squares.capacity();
+        for (u32 i = 0 ; i < 100 ; i++) {
+            squares[i] = i * i;
+        }
+        assert_equals("test_flatMap(): size", squares.size(), 100)
+        assert_equals("test_flatMap(): reserved", squares.capacity(), capacity)
+        assert_equals("test_flatMap(): find", squares.find(7)->second, 49)
+        assert_equals("test_flatMap(): missing", squares.contains(100), false)
+
+        // erased slots are reused and don't break probing of other keys
+        for (u32 i = 0 ; i < 100 ; i += 2) {
+            squares.erase(i);
+        }
+        for (u32 i = 100 ; i < 150 ; i++) {
+            squares.emplace(i, i * i);
+        }
+        u64 sum = 0;
+        for (const auto& square : squares) {
+            sum += square.first;
+        }
+        assert_equals("test_flatMap(): erased", squares.size(), 100)
+        assert_equals("test_flatMap(): iterated", sum, 2500 + 6225)
+        assert_equals("test_flatMap(): after erase", squares.at(149), 149 * 149)
+        assert_equals("test_flatMap(): erased missing", squares.count(50), 0)
+        assert_equals("test_flatMap(): no growth", squares.capacity(), capacity)
+
+        // string keys are found by views without allocating temporary strings
+        flat_map<std::string, u32> ids;
+        ids.try_emplace("cube", 1);
+        ids.insert_or_assign("sphere", 2);
+        assert_equals("test_flatMap(): try emplace", ids.try_emplace("cube", 3).second, false)
+        assert_equals("test_flatMap(): string view", ids.at(std::string_view("sphere")), 2)
+        assert_equals("test_flatMap(): c string", ids.find("cube")->second, 1)
+        ids.erase(std::string_view("cube"));
+        assert_equals("test_flatMap(): erase view", ids.contains("cube"), false)
+
+        // copies are deep
+        flat_map<std::string, u32> copied = ids;
+        copied["sphere"] = 5;
+        assert_equals("test_flatMap(): copy", ids["sphere"], 2)
+
+        flat_set<u64> entities;
+        for (u64 i = 0 ; i < 1000 ; i++) {
+            entities.insert(i % 10);
+        }
+        assert_equals("test_flatMap(): set", entities.size(), 10)
+        entities.clear();
+        assert_equals("test_flatMap(): cleared", entities.empty(), true)
+    }
+
+    void test_suite() {
+        RUNTIME_WARN("test_suite() started!");
+
+        RUNTIME_WARN("Running test_jobScheduler()");
+        test_jobScheduler();
+
+        RUNTIME_WARN("Running test_jobHandles()");
+        test_jobHandles();
+
+        RUNTIME_WARN("Running test_jobStorage()");
+        test_jobStorage();
+
+        RUNTIME_WARN("Running test_jobSystem()");
+        test_jobSystem();
+
+        RUNTIME_WARN("Running test_tasks()");
+        test_tasks();
+
+        RUNTIME_WARN("Running test_timerWheel()");
+        test_timerWheel();
+
+        RUNTIME_WARN("Running test_timers()");
+        test_timers();
+
+        RUNTIME_WARN("Running test_frameArena()");
+        test_frameArena();
+
+        RUNTIME_WARN("Running test_allocators()");
+        test_allocators();
+
+        RUNTIME_WARN("Running test_arrays()");
+        test_arrays();
+
+        RUNTIME_WARN("Running test_flatMap()");
+        test_flatMap();
+
+        RUNTIME_WARN("test_suite() ended!");
+    }
+}
\ No newline at end of file
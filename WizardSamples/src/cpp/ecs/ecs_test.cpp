@@ -4,6 +4,8 @@
 
 #include <core.h>
 #include <ecs/ecs_test.h>
+#include <core/job_system.h>
+#include <ecs/SystemScheduler.h>
 
 namespace test::ecs {
 
@@ -63,6 +65,40 @@ namespace test::ecs {
         assert_null("deleteEntity(entity2)", entity2);
     }
 
+    void test_entityHandles() {
+        empty_component(Test)
+        Registry registry;
+
+        entity_id entity1 = registry.createEntity<Test>();
+        entity_id entity2 = registry.createEntity<Test>();
+        assert_equals("isAlive(entity1)", registry.isAlive(entity1), true)
+        assert_equals("isAlive(invalid_entity_id)", registry.isAlive(invalid_entity_id), false)
+
+        entity_id staleEntity1 = entity1;
+        registry.deleteEntity(entity1);
+        assert_equals("isAlive(staleEntity1)", registry.isAlive(staleEntity1), false)
+        assert_equals("isAlive(entity2)", registry.isAlive(entity2), true)
+
+        // deleted record is reused, but with a new generation
+        entity_id entity3 = registry.createEntity();
+        assert_equals("entity_index(entity3)", entity_index(entity3), entity_index(staleEntity1))
+        assert_equals("entity3 != staleEntity1", entity3 != staleEntity1, true)
+        assert_equals("isAlive(staleEntity1) after reuse", registry.isAlive(staleEntity1), false)
+        assert_equals("entity_count()", registry.entity_count(), 2)
+
+        u32 count = 0;
+        registry.eachEntity([&count](entity_id) {
+            count++;
+        });
+        assert_equals("eachEntity() elements count", count, 2)
+
+        registry.clear();
+        assert_equals("isAlive(entity2) after clear()", registry.isAlive(entity2), false)
+        assert_equals("isAlive(entity3) after clear()", registry.isAlive(entity3), false)
+        entity_id entity4 = registry.createEntity();
+        assert_equals("isAlive(entity4)", registry.isAlive(entity4), true)
+    }
+
     void test_components() {
         component(Position) {
             f32 x = 0;
@@ -203,9 +239,762 @@ namespace test::ecs {
         assert_equals("registry.clear()", registry.entity_count(), 0);
     }
 
+    void test_archetypes() {
+        component(Position) {
+            f32 x = 0;
+            f32 y = 0;
+            Position(const f32& x, const f32& y)
+            : x(x), y(y) {}
+        };
+
+        component(Velocity) {
+            f32 dx = 0;
+            f32 dy = 0;
+            Velocity(const f32& dx, const f32& dy)
+            : dx(dx), dy(dy) {}
+        };
+
+        component(Health) {
+            u32 value = 0;
+            Health(const u32& value) : value(value) {}
+        };
+
+        Registry registry;
+        // enough entities to span several chunks of the same archetype
+        const u32 entityCount = 5000;
+        vector<entity_id> entities;
+        for (u32 i = 0 ; i < entityCount ; i++) {
+            entity_id entityId = registry.createEntity<Position>((f32) i, (f32) i);
+            if (i % 2 == 0) {
+                registry.addComponent<Velocity>(entityId, 1.0f, 2.0f);
+            }
+            if (i % 3 == 0) {
+                registry.addComponent<Health>(entityId, i);
+            }
+            entities.emplace_back(entityId);
+        }
+
+        assert_equals("component_count<Position>()", registry.component_count<Position>(), entityCount)
+        assert_equals("component_count<Velocity>()", registry.component_count<Velocity>(), 2500)
+        assert_equals("component_count<Health>()", registry.component_count<Health>(), 1667)
+
+        // moving entities between archetypes must keep component values
+        bool valuesKept = true;
+        for (u32 i = 0 ; i < entityCount ; i++) {
+            auto* position = registry.getComponent<Position>(entities[i]);
+            valuesKept &= position && position->x == (f32) i && position->entityId == entities[i];
+            auto* health = registry.getComponent<Health>(entities[i]);
+            valuesKept &= (i % 3 == 0) == (health != nullptr);
+            if (health) {
+                valuesKept &= health->value == i;
+            }
+        }
+        assert_equals("archetype moves keep components", valuesKept, true)
+
+        u32 count = 0;
+        registry.each<Position, Velocity, Health>([&count](Position* position, Velocity* velocity, Health*) {
+            position->x += velocity->dx;
+            count++;
+        });
+        assert_equals("each<Position, Velocity, Health>() elements count", count, 834)
+
+        for (u32 i = 0 ; i < entityCount ; i += 2) {
+            registry.removeComponent<Velocity>(entities[i]);
+        }
+        assert_equals("removeComponent<Velocity>()", registry.component_count<Velocity>(), 0)
+
+        for (u32 i = 0 ; i < entityCount ; i += 5) {
+            registry.deleteEntity(entities[i]);
+        }
+        assert_equals("deleteEntity() entity_count()", registry.entity_count(), 4000)
+
+        valuesKept = true;
+        for (u32 i = 0 ; i < entityCount ; i++) {
+            if (i % 5 == 0) continue;
+            auto* position = registry.getComponent<Position>(entities[i]);
+            f32 expectedX = i % 6 == 0 ? (f32) i + 1.0f : (f32) i;
+            valuesKept &= position && position->x == expectedX && position->y == (f32) i;
+        }
+        assert_equals("deleteEntity() keeps other entities", valuesKept, true)
+
+        registry.clear();
+        assert_equals("registry.clear()", registry.entity_count(), 0);
+    }
+
+    void test_componentLookup() {
+        component(A) {
+            u32 value = 0;
+            A(const u32& value) : value(value) {}
+        };
+
+        component(B) {
+            u32 value = 0;
+            B(const u32& value) : value(value) {}
+        };
+
+        component(C) {
+            u32 value = 0;
+            C(const u32& value) : value(value) {}
+        };
+
+        // reference model of entity components, the way entity pair vector used to store them
+        struct Expected {
+            entity_id id = invalid_entity_id;
+            std::map<u32, u32> components; // component index -> value
+        };
+
+        Registry registry;
+        vector<Expected> expected(1000);
+        for (auto& e : expected) {
+            e.id = registry.createEntity();
+        }
+
+        // deterministic pseudo-random operations
+        u32 seed = 12345;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+
+        bool same = true;
+        for (u32 step = 0 ; step < 20000 ; step++) {
+            auto& e = expected[next() % expected.size()];
+            u32 componentIndex = next() % 3;
+            u32 value = next();
+            bool had = e.components.find(componentIndex) != e.components.end();
+
+            switch (next() % 3) {
+                case 0:
+                    if (componentIndex == 0) registry.addComponent<A>(e.id, value);
+                    if (componentIndex == 1) registry.addComponent<B>(e.id, value);
+                    if (componentIndex == 2) registry.addComponent<C>(e.id, value);
+                    e.components[componentIndex] = value;
+                    break;
+                case 1: {
+                    bool removed = false;
+                    if (componentIndex == 0) removed = registry.removeComponent<A>(e.id);
+                    if (componentIndex == 1) removed = registry.removeComponent<B>(e.id);
+                    if (componentIndex == 2) removed = registry.removeComponent<C>(e.id);
+                    same &= removed == had;
+                    e.components.erase(componentIndex);
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            // get/has must agree with reference model for every component type
+            auto checkComponent = [&same](const Expected& e, u32 index, auto* component, bool has) {
+                auto it = e.components.find(index);
+                bool expectedHas = it != e.components.end();
+                same &= has == expectedHas;
+                same &= (component != nullptr) == expectedHas;
+                if (component && expectedHas) {
+                    same &= component->value == it->second && component->entityId == e.id;
+                }
+            };
+            checkComponent(e, 0, registry.getComponent<A>(e.id), registry.hasComponent<A>(e.id));
+            checkComponent(e, 1, registry.getComponent<B>(e.id), registry.hasComponent<B>(e.id));
+            checkComponent(e, 2, registry.getComponent<C>(e.id), registry.hasComponent<C>(e.id));
+        }
+        assert_equals("get/has/remove match reference model", same, true)
+
+        size_t countA = 0;
+        for (const auto& e : expected) {
+            countA += e.components.count(0);
+        }
+        assert_equals("component_count<A>()", registry.component_count<A>(), countA)
+
+        registry.clear();
+        assert_equals("registry.clear()", registry.entity_count(), 0);
+    }
+
+    // workers are detached and live until process exit, so scheduler is never destroyed
+    static engine::core::JobScheduler<16>& test_scheduler() {
+        static auto* scheduler = new engine::core::JobScheduler<16>(3, engine::thread::ThreadFormat(engine::thread::NORMAL, "TestWorker"));
+        return *scheduler;
+    }
+
+    void test_chunkPool() {
+        // archetype chunks come from shared ECS pool
+        size_t usedChunks = archetype_chunk_pool().getUsedBlocks();
+        {
+            Registry registry;
+            registry.createEntity<TestComponent>(TestComponent());
+            assert_equals("test_chunkPool(): chunk pool", archetype_chunk_pool().getUsedBlocks() > usedChunks, true)
+        }
+        assert_equals("test_chunkPool(): chunk released", archetype_chunk_pool().getUsedBlocks(), usedChunks)
+    }
+
+    void test_parallelEach() {
+        component(Value) {
+            u32 value = 0;
+            Value(const u32& value) : value(value) {}
+        };
+
+        component(Visits) {
+            std::atomic<u32>* counter = nullptr;
+            u32 count = 0;
+            Visits(std::atomic<u32>* counter) : counter(counter) {}
+        };
+
+        Registry registry;
+        std::atomic<u32> visited { 0 };
+        for (u32 i = 0 ; i < 10000 ; i++) {
+            entity_id entityId = registry.createEntity<Value>(i);
+            if (i % 3 == 0) {
+                registry.addComponent<Visits>(entityId, &visited);
+            }
+        }
+
+        registry.parallelEach<Value>(test_scheduler(), 100, [](Value* value) {
+            value->value *= 2;
+        });
+        registry.parallelEach<Value, Visits>(test_scheduler(), 7, [](Value*, Visits* visits) {
+            visits->count++;
+            visits->counter->fetch_add(1);
+        });
+
+        bool doubled = true;
+        registry.each<Value>([&doubled](Value* value) {
+            doubled &= value->value == 2 * entity_index(value->entityId);
+        });
+        assert_equals("parallelEach<Value>() updated every component once", doubled, true)
+
+        bool visitedOnce = true;
+        registry.each<Visits>([&visitedOnce](Visits* visits) {
+            visitedOnce &= visits->count == 1;
+        });
+        assert_equals("parallelEach<Value, Visits>() visited every component once", visitedOnce, true)
+        assert_equals("parallelEach<Value, Visits>() elements count", visited.load(), 3334)
+    }
+
+    void test_commandBuffer() {
+        component(Value) {
+            u32 value = 0;
+            Value(const u32& value) : value(value) {}
+        };
+
+        component(Name) {
+            std::string name;
+            Name(const std::string& name) : name(name) {}
+        };
+
+        empty_component(Spawner)
+
+        Registry registry;
+        for (u32 i = 0 ; i < 1000 ; i++) {
+            registry.createEntity<Value>(i);
+        }
+
+        // odd entities spawn a named copy of themselves, even entities are deleted
+        registry.parallelEach<Value>(test_scheduler(), 64, [&registry](Value* value) {
+            CommandBuffer& commands = registry.getCommandBuffer();
+            if (value->value % 2 == 0) {
+                commands.deleteEntity(value->entityId);
+            } else {
+                entity_id spawned = commands.createEntity();
+                commands.addComponent<Value>(spawned, value->value + 1000);
+                commands.addComponent<Name>(spawned, "spawned-" + std::to_string(value->value));
+                commands.addComponent<Spawner>(value->entityId);
+            }
+        });
+        assert_equals("entity_count() before flushCommands()", registry.entity_count(), 1000)
+
+        registry.flushCommands();
+        assert_equals("entity_count() after flushCommands()", registry.entity_count(), 1000)
+        assert_equals("component_count<Spawner>()", registry.component_count<Spawner>(), 500)
+        assert_equals("component_count<Name>()", registry.component_count<Name>(), 500)
+
+        bool namesValid = true;
+        registry.each<Value, Name>([&namesValid](Value* value, Name* name) {
+            namesValid &= name->name == "spawned-" + std::to_string(value->value - 1000);
+        });
+        assert_equals("spawned components are valid", namesValid, true)
+
+        // pending entity ends up only with components, that were left after all its commands
+        CommandBuffer& commands = registry.getCommandBuffer();
+        entity_id existing = registry.createEntity<Value>(1u);
+        entity_id pending = commands.createEntity();
+        commands.addComponent<Name>(pending, "removed");
+        commands.addComponent<Value>(pending, 1u);
+        commands.removeComponent<Name>(pending);
+        commands.updateComponent<Value>(pending, 7777u);
+        commands.updateComponent<Name>(existing, "ignored");
+        commands.updateComponent<Value>(existing, 2u);
+        entity_id deletedPending = commands.createEntity();
+        commands.addComponent<Value>(deletedPending, 3u);
+        commands.deleteEntity(deletedPending);
+        registry.flushCommands();
+
+        assert_equals("updateComponent() of missing component", registry.hasComponent<Name>(existing), false)
+        assert_equals("updateComponent() of existing component", registry.getComponent<Value>(existing)->value, 2)
+        assert_equals("entity_count() after pending commands", registry.entity_count(), 1002)
+        u32 sevens = 0;
+        registry.each<Value>([&sevens](Value* value) {
+            sevens += value->value == 7777;
+        });
+        assert_equals("pending entity components", sevens, 1)
+        assert_equals("command buffer is empty after flush", commands.empty(), true)
+
+        // added hooks see all components of pending entity
+        u32 hooked = 0;
+        registry.onAdded<Value>([&registry, &hooked](Value* value) {
+            hooked += registry.getComponent<Name>(value->entityId)->name == "hooked";
+        });
+        registry.onAdded<Name>([&registry, &hooked](Name* name) {
+            hooked += registry.getComponent<Value>(name->entityId)->value == 42;
+        });
+        entity_id hookedEntity = commands.createEntity();
+        commands.addComponent<Value>(hookedEntity, 42u);
+        commands.addComponent<Name>(hookedEntity, "hooked");
+        registry.flushCommands();
+        assert_equals("added hooks of pending entity", hooked, 2)
+    }
+
+    void test_changeDetection() {
+        component(Value) {
+            u32 value = 0;
+            Value(const u32& value) : value(value) {}
+        };
+
+        empty_component(Other)
+
+        Registry registry;
+        registry.trackRemoved<Value>();
+        vector<entity_id> entities;
+        for (u32 i = 0 ; i < 10 ; i++) {
+            entities.emplace_back(registry.createEntity<Value>(i));
+        }
+
+        u32 count = 0;
+        auto countValues = [&count](Value*) { count++; };
+        auto countEntities = [&count](entity_id) { count++; };
+
+        component_version createdVersion = registry.nextVersion();
+        registry.eachAdded<Value>(0, countValues);
+        assert_equals("eachAdded<Value>(0)", count, 10)
+        count = 0;
+        registry.eachChanged<Value>(createdVersion, countValues);
+        assert_equals("eachChanged<Value>() without changes", count, 0)
+
+        registry.updateComponent<Value>(entities[3], 33u);
+        registry.markChanged<Value>(entities[5]);
+        // changed version must survive moving into another archetype
+        registry.addComponent<Other>(entities[5]);
+        registry.removeComponent<Value>(entities[7]);
+        registry.deleteEntity(entities[8]);
+
+        vector<u32> changed;
+        registry.eachChanged<Value>(createdVersion, [&changed](Value* value) {
+            changed.emplace_back(value->value);
+        });
+        std::sort(changed.begin(), changed.end());
+        assert_equals("eachChanged<Value>() count", changed.size(), 2)
+        assert_equals("eachChanged<Value>() updated", changed[0], 5)
+        assert_equals("eachChanged<Value>() marked", changed[1], 33)
+
+        count = 0;
+        registry.eachAdded<Value>(createdVersion, countValues);
+        assert_equals("eachAdded<Value>() after changes", count, 0)
+        count = 0;
+        registry.eachAdded<Other>(createdVersion, [&count](Other*) { count++; });
+        assert_equals("eachAdded<Other>()", count, 1)
+        count = 0;
+        registry.eachRemoved<Value>(createdVersion, countEntities);
+        assert_equals("eachRemoved<Value>()", count, 2)
+
+        component_version changedVersion = registry.nextVersion();
+        count = 0;
+        registry.eachChanged<Value>(changedVersion, countValues);
+        assert_equals("eachChanged<Value>() after nextVersion()", count, 0)
+        registry.clearRemoved<Value>(changedVersion);
+        count = 0;
+        registry.eachRemoved<Value>(0, countEntities);
+        assert_equals("eachRemoved<Value>() after clearRemoved()", count, 0)
+    }
+
+    void test_queries() {
+        empty_component(A)
+        empty_component(B)
+        empty_component(C)
+        empty_component(D)
+
+        Registry registry;
+        for (u32 i = 0 ; i < 30 ; i++) {
+            entity_id entityId = registry.createEntity<A>();
+            if (i % 2 == 0) registry.addComponent<B>(entityId);
+            if (i % 3 == 0) registry.addComponent<C>(entityId);
+        }
+
+        Query& query = registry.query<A, B>();
+        assert_equals("query<A, B>() archetypes count", query.getArchetypeCount(), 2)
+        assert_equals("query<A, B>() entities count", query.getEntityCount(), 15)
+        bool cached = &registry.query<A, B>() == &query;
+        assert_equals("query<A, B>() is cached", cached, true)
+
+        // new archetype is matched by existing query
+        entity_id entityId = registry.createEntity<D>();
+        registry.addComponent<B>(entityId);
+        registry.addComponent<A>(entityId);
+        assert_equals("query<A, B>() archetypes count after new archetype", query.getArchetypeCount(), 3)
+
+        u32 count = 0;
+        registry.each<A, B>([&count](A*, B*) {
+            count++;
+        });
+        assert_equals("each<A, B>() elements count", count, 16)
+
+        registry.clear();
+        assert_equals("query<A, B>() archetypes count after clear()", query.getArchetypeCount(), 0)
+        registry.createEntity<B>();
+        registry.addComponent<A>(registry.createEntity<B>());
+        assert_equals("query<A, B>() entities count after clear()", query.getEntityCount(), 1)
+    }
+
+    void test_bulkCreation() {
+        component(Position) {
+            f32 x = 0, y = 0;
+        };
+
+        component(Velocity) {
+            f32 x = 0, y = 0;
+        };
+
+        component(Name) {
+            std::string name;
+            Name() = default;
+            Name(const std::string& name) : name(name) {}
+        };
+
+        Registry registry;
+        vector<entity_id> entities = registry.createEntities<Position, Velocity>(100000, [](u32 i, Position* position, Velocity* velocity) {
+            position->x = (f32) i;
+            velocity->y = (f32) i * 2;
+        });
+        assert_equals("createEntities() entities count", registry.entity_count(), 100000)
+        assert_equals("createEntities() components count", registry.component_count<Velocity>(), 100000)
+        assert_equals("createEntities() initializes components", registry.getComponent<Velocity>(entities[500])->y, 1000)
+        assert_equals("createEntities() sets entity id", registry.getComponent<Position>(entities[700])->entityId, entities[700])
+
+        vector<entity_id> named;
+        vector<Name> names;
+        for (u32 i = 0 ; i < entities.size() ; i += 2) {
+            named.emplace_back(entities[i]);
+            names.emplace_back("entity-" + std::to_string(i));
+        }
+        registry.addComponents<Name>(named, names);
+        assert_equals("addComponents() components count", registry.component_count<Name>(), 50000)
+        assert_equals("addComponents() keeps components", registry.getComponent<Position>(entities[1000])->x, 1000)
+        assert_equals("addComponents() copies components", registry.getComponent<Name>(entities[1000])->name, "entity-1000")
+        assert_equals("addComponents() sets entity id", registry.getComponent<Name>(entities[1000])->entityId, entities[1000])
+    }
+
+    void test_componentRelocation() {
+        // remembers its own address, which becomes stale if component is relocated with memcpy
+        component(SelfRef) {
+            SelfRef* self = this;
+            std::string name;
+            SelfRef(const std::string& name) : name(name) {}
+            SelfRef(const SelfRef& other) : name(other.name) {}
+            SelfRef(SelfRef&& other) noexcept : name(std::move(other.name)) {}
+        };
+
+        empty_component(Marker)
+
+        assert_equals("SelfRef is not trivially copyable", BaseComponent::getRelocateFunction(SelfRef::ID) != nullptr, true)
+        assert_equals("Marker is trivially copyable", BaseComponent::getRelocateFunction(Marker::ID) == nullptr, true)
+        // registration of the same type returns the same id
+        component_id id = BaseComponent::registerComponentType(
+                createComponent<SelfRef>, destroyComponent<SelfRef>, relocateComponent<SelfRef>,
+                sizeof(SelfRef), type_hash<SelfRef>(), "SelfRef"
+        );
+        assert_equals("registerComponentType() of registered type", id, SelfRef::ID)
+
+        Registry registry;
+        vector<entity_id> entities;
+        for (u32 i = 0 ; i < 1000 ; i++) {
+            std::string name = "long enough name to be allocated on heap " + std::to_string(i);
+            entities.emplace_back(registry.createEntity<SelfRef>(name));
+        }
+        for (u32 i = 0 ; i < entities.size() ; i += 2) {
+            registry.addComponent<Marker>(entities[i]);
+        }
+        for (u32 i = 0 ; i < entities.size() ; i += 3) {
+            registry.deleteEntity(entities[i]);
+        }
+        for (u32 i = 2 ; i < entities.size() ; i += 6) {
+            registry.removeComponent<Marker>(entities[i]);
+        }
+
+        bool valid = true;
+        registry.each<SelfRef>([&valid](SelfRef* selfRef) {
+            valid &= selfRef->self == selfRef;
+            std::string expectedName = "long enough name to be allocated on heap " + std::to_string(entity_index(selfRef->entityId));
+            valid &= selfRef->name == expectedName;
+        });
+        assert_equals("relocated components are valid", valid, true)
+    }
+
+    void test_registrySnapshot() {
+        component(Position) {
+            f32 x = 0, y = 0;
+        };
+
+        component(Name) {
+            Name* self = this;
+            std::string name;
+            Name() = default;
+            Name(const std::string& name) : name(name) {}
+            Name(const Name& other) : name(other.name) {}
+        };
+
+        Registry registry;
+        vector<entity_id> entities = registry.createEntities<Position, Name>(5000, [](u32 i, Position* position, Name* name) {
+            position->x = (f32) i;
+            name->name = "long enough name to be allocated on heap " + std::to_string(i);
+        });
+        for (u32 i = 0 ; i < entities.size() ; i += 4) {
+            registry.deleteEntity(entities[i]);
+        }
+        entity_id emptyEntity = registry.createEntity();
+
+        Scope<Registry> snapshot = registry.snapshot();
+        assert_equals("test_registrySnapshot(): snapshot entity count", snapshot->entity_count(), registry.entity_count())
+
+        // play mode: modify, delete and create entities
+        registry.each<Position>([](Position* position) {
+            position->x = -1;
+        });
+        entity_id deletedEntity = entities[1];
+        registry.deleteEntity(deletedEntity);
+        entity_id playEntity = registry.createEntity<Position>();
+
+        registry.restore(*snapshot);
+        assert_equals("test_registrySnapshot(): restored entity count", registry.entity_count(), snapshot->entity_count())
+        assert_equals("test_registrySnapshot(): entity created in play mode is stale", registry.isAlive(playEntity), false)
+        assert_equals("test_registrySnapshot(): entity without components is restored", registry.isAlive(emptyEntity), true)
+
+        bool valid = true;
+        for (u32 i = 0 ; i < entities.size() ; i++) {
+            bool alive = registry.isAlive(entities[i]);
+            valid &= alive == (i % 4 != 0);
+            if (!alive) continue;
+            valid &= registry.getComponent<Position>(entities[i])->x == (f32) i;
+            Name* name = registry.getComponent<Name>(entities[i]);
+            valid &= name->self == name && name->entityId == entities[i];
+            valid &= name->name == "long enough name to be allocated on heap " + std::to_string(i);
+        }
+        assert_equals("test_registrySnapshot(): restored components", valid, true)
+
+        // restored registry is fully functional
+        entity_id newEntity = registry.createEntity<Position>();
+        registry.removeComponent<Name>(entities[2]);
+        size_t positions = 0;
+        registry.each<Position>([&positions](Position*) {
+            positions++;
+        });
+        assert_equals("test_registrySnapshot(): iterate restored registry", positions, snapshot->entity_count())
+        bool aliased = newEntity == playEntity;
+        assert_equals("test_registrySnapshot(): recycled handle differs from stale one", aliased, false)
+
+        // partial clone merges archetypes, which differ only by skipped components
+        entity_id onlyName = registry.createEntity<Name>();
+        Registry partial;
+        registry.clone(partial, { Name::ID });
+        assert_equals("test_registrySnapshot(): partial entity count", partial.entity_count(), registry.entity_count())
+        assert_equals("test_registrySnapshot(): skipped component", partial.hasComponent<Name>(entities[1]), false)
+        assert_equals("test_registrySnapshot(): entity without copied components", partial.isAlive(onlyName), true)
+        valid = true;
+        for (u32 i = 1 ; i < entities.size() ; i++) {
+            if (i % 4 == 0) continue;
+            valid &= partial.getComponent<Position>(entities[i])->x == (f32) i;
+        }
+        valid &= partial.getComponent<Position>(newEntity)->x == 0;
+        assert_equals("test_registrySnapshot(): partial components", valid, true)
+    }
+
+    void test_sort() {
+        component(Material) {
+            u32 shader = 0;
+            u32 texture = 0;
+        };
+
+        component(Name) {
+            Name* self = this;
+            std::string name;
+            Name() = default;
+            Name(const Name& other) : name(other.name) {}
+            Name(Name&& other) noexcept : name(std::move(other.name)) {}
+        };
+
+        auto byShaderAndTexture = [](const Material& a, const Material& b) {
+            return a.shader != b.shader ? a.shader < b.shader : a.texture < b.texture;
+        };
+        auto sorted = [&byShaderAndTexture](Registry& registry) {
+            bool sorted = true;
+            const Material* previous = nullptr;
+            registry.each<Material>([&](Material* material) {
+                sorted &= previous == nullptr || !byShaderAndTexture(*material, *previous);
+                previous = material;
+            });
+            return sorted;
+        };
+
+        Registry registry;
+        vector<entity_id> entities = registry.createEntities<Material, Name>(3000, [](u32 i, Material* material, Name* name) {
+            material->shader = (i * 7919) % 13;
+            material->texture = (i * 104729) % 101;
+            name->name = "long enough name to be allocated on heap " + std::to_string(i);
+        });
+        registry.sort<Material>(byShaderAndTexture);
+        assert_equals("test_sort(): sorted materials", sorted(registry), true)
+
+        bool valid = true;
+        for (u32 i = 0 ; i < entities.size() ; i++) {
+            auto* material = registry.getComponent<Material>(entities[i]);
+            auto* name = registry.getComponent<Name>(entities[i]);
+            valid &= material->entityId == entities[i] && name->entityId == entities[i];
+            valid &= material->shader == (i * 7919) % 13 && material->texture == (i * 104729) % 101;
+            valid &= name->self == name && name->name == "long enough name to be allocated on heap " + std::to_string(i);
+        }
+        assert_equals("test_sort(): handles and paired components", valid, true)
+
+        // nearly sorted archetype is sorted by insertion
+        registry.getComponent<Material>(entities[10])->shader = 0;
+        registry.getComponent<Material>(entities[20])->shader = 12;
+        registry.sort<Material>(byShaderAndTexture);
+        assert_equals("test_sort(): resorted materials", sorted(registry), true)
+
+        // sorted registry stays functional
+        for (u32 i = 0 ; i < entities.size() ; i += 3) {
+            registry.deleteEntity(entities[i]);
+        }
+        size_t count = 0;
+        registry.each<Material, Name>([&count](Material* material, Name* name) {
+            count += material->entityId == name->entityId;
+        });
+        assert_equals("test_sort(): iterate after delete", count, 2000)
+    }
+
+    void test_systemScheduler() {
+        empty_component(Position)
+        empty_component(Velocity)
+        empty_component(Color)
+
+        SystemScheduler systems;
+        std::mutex logMutex;
+        vector<std::string> log;
+        auto logSystem = [&log, &logMutex](const std::string& name) {
+            return [&log, &logMutex, name]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                std::lock_guard<std::mutex> lock(logMutex);
+                log.emplace_back(name);
+            };
+        };
+        systems.addSystem("Move", logSystem("Move")).read<Velocity>().write<Position>();
+        systems.addSystem("Paint", logSystem("Paint")).write<Color>();
+        systems.addSystem("Accelerate", logSystem("Accelerate")).write<Velocity>();
+        systems.addSystem("Flush", logSystem("Flush")).makeExclusive();
+        systems.addSystem("Draw", logSystem("Draw")).read<Position, Color>();
+        systems.addSystem("Idle", logSystem("Idle"));
+
+        for (u32 frame = 0 ; frame < 100 ; frame++) {
+            log.clear();
+            systems.run(test_scheduler());
+            auto position = [&log](const std::string& name) {
+                return std::find(log.begin(), log.end(), name) - log.begin();
+            };
+            bool ordered = log.size() == systems.size()
+            && position("Move") < position("Accelerate")
+            && position("Move") < position("Flush")
+            && position("Paint") < position("Flush")
+            && position("Accelerate") < position("Flush")
+            && position("Flush") < position("Draw")
+            && position("Flush") < position("Idle");
+            if (!ordered) {
+                assert_equals("test_systemScheduler(): conflicting systems order", ordered, true)
+            }
+        }
+        assert_equals("test_systemScheduler(): systems run", log.size(), systems.size())
+
+        // systems may run nested parallel jobs on the same scheduler
+        Registry registry;
+        component(Value) {
+            u32 value = 0;
+        };
+        registry.createEntities<Value>(10000, [](u32 i, Value* value) {
+            value->value = i;
+        });
+        SystemScheduler nestedSystems;
+        for (u32 i = 0 ; i < 4 ; i++) {
+            nestedSystems.addSystem("Nested", [&registry]() {
+                registry.parallelEach<Value>(test_scheduler(), 100, [](Value* value) {
+                    value->value++;
+                });
+            }).write<Value>();
+        }
+        nestedSystems.run(test_scheduler());
+        bool valid = true;
+        u32 i = 0;
+        registry.each<Value>([&valid, &i](Value* value) {
+            valid &= value->value == i++ + 4;
+        });
+        assert_equals("test_systemScheduler(): nested parallel jobs", valid, true)
+
+        // systems, which run at the same time, share workers with their nested jobs
+        SystemScheduler readers;
+        std::atomic<u64> sum = 0;
+        for (u32 i = 0 ; i < 8 ; i++) {
+            readers.addSystem("Reader", [&registry, &sum]() {
+                registry.parallelEach<Value>(test_scheduler(), 100, [&sum](Value* value) {
+                    sum += value->value;
+                });
+            }).read<Value>();
+        }
+        readers.run(test_scheduler());
+        assert_equals("test_systemScheduler(): parallel systems with nested jobs", sum.load(), 8 * (49995000 + 40000))
+    }
+
     void test_scene() {
         auto scene = createRef<Scene>("Test");
 
+        vector<Entity> entities;
+        for (int i = 0 ; i < 1000 ; i++) {
+            entities.emplace_back("Entity", scene.get());
+            entities.back().setUUID(engine::uuid(i + 1));
+        }
+        bool foundAll = true;
+        for (int i = 0 ; i < 1000 ; i++) {
+            foundAll &= scene->findEntity(i + 1).getId() == entities[i].getId();
+        }
+        assert_equals("test_scene(): find entities by uuid", foundAll, true)
+
+        // replaced uuid is found by new value only
+        entities[0].setUUID(engine::uuid(5000));
+        assert_equals("test_scene(): find replaced uuid", scene->findEntity(5000).getId(), entities[0].getId())
+        assert_equals("test_scene(): old uuid is gone", scene->findEntity(1).getId(), invalid_entity_id)
+
+        // removed component and deleted entity are not found
+        scene->removeComponent<UUIDComponent>(entities[1].getId());
+        assert_equals("test_scene(): removed uuid", scene->findEntity(2).getId(), invalid_entity_id)
+        entities[2].destroy();
+        assert_equals("test_scene(): deleted entity", scene->findEntity(3).getId(), invalid_entity_id)
+        assert_equals("test_scene(): moved entity", scene->findEntity(1000).getId(), entities[999].getId())
+
+        // components added by command buffers are indexed on flush
+        entity_id deferredEntity = scene->getRegistry().getCommandBuffer().createEntity();
+        scene->getRegistry().getCommandBuffer().addComponent<UUIDComponent>(deferredEntity, engine::uuid(6000));
+        scene->getRegistry().flushCommands();
+        bool deferredFound = scene->isAlive(scene->findEntity(6000).getId());
+        assert_equals("test_scene(): deferred uuid", deferredFound, true)
+
+        auto* tag = scene->findComponent<TagComponent>(engine::uuid(500));
+        bool tagFound = tag != nullptr && tag->tag == "Entity";
+        assert_equals("test_scene(): find component by uuid", tagFound, true)
+
+        scene->clear();
+        assert_equals("test_scene(): cleared scene", scene->findEntity(500).getId(), invalid_entity_id)
     }
 
     void test_serializeComponents() {
@@ -372,9 +1161,51 @@ namespace test::ecs {
         RUNTIME_WARN("Running test_entity()");
         test_entity();
 
+        RUNTIME_WARN("Running test_entityHandles()");
+        test_entityHandles();
+
         RUNTIME_WARN("Running test_components()");
         test_components();
 
+        RUNTIME_WARN("Running test_archetypes()");
+        test_archetypes();
+
+        RUNTIME_WARN("Running test_componentLookup()");
+        test_componentLookup();
+
+        RUNTIME_WARN("Running test_chunkPool()");
+        test_chunkPool();
+
+        RUNTIME_WARN("Running test_parallelEach()");
+        test_parallelEach();
+
+        RUNTIME_WARN("Running test_commandBuffer()");
+        test_commandBuffer();
+
+        RUNTIME_WARN("Running test_changeDetection()");
+        test_changeDetection();
+
+        RUNTIME_WARN("Running test_queries()");
+        test_queries();
+
+        RUNTIME_WARN("Running test_bulkCreation()");
+        test_bulkCreation();
+
+        RUNTIME_WARN("Running test_componentRelocation()");
+        test_componentRelocation();
+
+        RUNTIME_WARN("Running test_registrySnapshot()");
+        test_registrySnapshot();
+
+        RUNTIME_WARN("Running test_sort()");
+        test_sort();
+
+        RUNTIME_WARN("Running test_systemScheduler()");
+        test_systemScheduler();
+
+        RUNTIME_WARN("Running test_scene()");
+        test_scene();
+
         RUNTIME_WARN("Running test_serializeComponents()");
         test_serializeComponents();
 
@@ -0,0 +1,26 @@
+//
+// Created by mecha on 17.10.2026.
+//
+
+#pragma once
+
+#include <core/job_system.h>
+
+namespace test::core {
+    // under testing
+    using namespace engine::core;
+    // tests
+    void test_jobScheduler();
+    void test_jobHandles();
+    void test_jobStorage();
+    void test_jobSystem();
+    void test_tasks();
+    void test_timerWheel();
+    void test_timers();
+    void test_frameArena();
+    void test_allocators();
+    void test_arrays();
+    void test_flatMap();
+    // test suites
+    void test_suite();
+}
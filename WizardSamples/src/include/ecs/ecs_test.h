@@ -13,7 +13,20 @@ namespace test::ecs {
     void test_registry_size(size_t size);
     void test_componentTypesRegistration();
     void test_entity();
+    void test_entityHandles();
     void test_components();
+    void test_archetypes();
+    void test_componentLookup();
+    void test_chunkPool();
+    void test_parallelEach();
+    void test_commandBuffer();
+    void test_changeDetection();
+    void test_queries();
+    void test_bulkCreation();
+    void test_componentRelocation();
+    void test_registrySnapshot();
+    void test_sort();
+    void test_systemScheduler();
     void test_scene();
     void test_serializeComponents();
     // test suites
@@ -2,6 +2,7 @@
 // Created by mecha on 03.04.2022.
 //
 
+#include <core/core_test.h>
 #include <ecs/ecs_test.h>
 
 int find_recurse(int* arr, int x, int low, int high) {
@@ -35,6 +36,7 @@ int main() {
     INIT_RUNTIME_LOG("Test");
 
     RUNTIME_INFO("Running test suite...");
+    test::core::test_suite();
     test::ecs::test_suite();
     RUNTIME_INFO("Test suite finished!");
 